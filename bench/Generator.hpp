@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <algorithm>
+#include <vector>
+
+/*
+ * Deterministic synthetic ILOC block generator.
+ *
+ * The block is made of `width` independent dependence chains interleaved
+ * round-robin, so `width` bounds the available ILP. Each chain is restarted
+ * from a fresh loadI after `depth` operations. Destination registers are
+ * handed out round-robin from a pool of `reuse` names, so a register name is
+ * redefined every `reuse` definitions (the pool is widened if it is too small
+ * to hold every live chain value). r0 holds a base address and r1 a constant
+ * operand for the whole block.
+ *
+ * With `slots` > 0 the block first stores to that many distinct constant
+ * addresses (spill slots) and loads a pointer from memory. Stores in the
+ * block then cycle through the slots and every load goes through the
+ * pointer, an address the scheduler cannot know: the worst case for memory
+ * disambiguation.
+ */
+struct GeneratorOptions {
+    long operations = 1000;
+    int width = 4;
+    int depth = 16;
+    double memoryRatio = 0.25;
+    double multDensity = 0.1;
+    int reuse = 64;
+    int slots = 0;
+    uint64_t seed = 1;
+};
+
+class Generator {
+public:
+    Generator(const GeneratorOptions& options) : options(options), state(options.seed) {}
+
+    void generate(std::ostream& out) {
+        int width = std::max(options.width, 1);
+        int depth = std::max(options.depth, 1);
+        int reuse = std::max(options.reuse, width + 1);
+
+        int nextRegister = 0;
+        auto allocate = [&] () {
+            int r = 2 + nextRegister;
+            nextRegister = (nextRegister + 1) % reuse;
+            return r;
+        };
+
+        out << "loadI 1024 => r0\n";
+        out << "loadI 3 => r1\n";
+
+        // Spill slots, and a pointer kept above the register pool
+        int pointer = 2 + reuse;
+        int slot = 0;
+        for (int s = 0; s < options.slots; s++) {
+            out << "loadI " << 8192 + s * 4 << " => r" << pointer << "\n";
+            out << "store r1 => r" << pointer << "\n";
+        }
+        if (options.slots > 0) {
+            out << "load r0 => r" << pointer << "\n";
+        }
+
+        std::vector<int> value(width);
+        std::vector<int> length(width, 0);
+        for (int c = 0; c < width; c++) {
+            value[c] = allocate();
+            out << "loadI " << c * 4 << " => r" << value[c] << "\n";
+        }
+
+        for (long i = 0; i < options.operations; i++) {
+            int c = i % width;
+
+            // Restart the chain from a fresh root
+            if (length[c] == depth) {
+                value[c] = allocate();
+                length[c] = 0;
+                out << "loadI " << next() % 4096 << " => r" << value[c] << "\n";
+                continue;
+            }
+            length[c]++;
+
+            if (uniform() < options.memoryRatio) {
+                double kind = uniform();
+                if (kind < 0.45) {
+                    int target = allocate();
+                    out << "load r" << (options.slots > 0 ? pointer : value[c]) << " => r" << target << "\n";
+                    value[c] = target;
+                } else if (kind < 0.9 && options.slots > 0) {
+                    out << "loadI " << 8192 + slot * 4 << " => r" << pointer + 1 << "\n";
+                    out << "store r" << value[c] << " => r" << pointer + 1 << "\n";
+                    slot = (slot + 1) % options.slots;
+                } else if (kind < 0.9) {
+                    out << "store r" << value[c] << " => r0\n";
+                } else {
+                    out << "output " << (next() % 16) * 4 << "\n";
+                }
+            } else {
+                int target = allocate();
+                const char* opcode = ARITHOPS[next() % 4];
+                if (uniform() < options.multDensity) {
+                    opcode = "mult";
+                }
+                out << opcode << " r" << value[c] << ", r1 => r" << target << "\n";
+                value[c] = target;
+            }
+        }
+    }
+
+private:
+    static constexpr const char* ARITHOPS[4] = {"add", "sub", "lshift", "rshift"};
+
+    GeneratorOptions options;
+    uint64_t state;
+
+    // splitmix64, so blocks are identical on every platform
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
@@ -0,0 +1,55 @@
+#include "Generator.hpp"
+#include <Scanner.hpp>
+#include <Diagnostics.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+/*
+ * Allocation-count check for the scanner. Every operator new in the process
+ * is counted; scanning a generated block, where nearly every token is a
+ * register or a constant, must not allocate once the scanner is built.
+ * Exits with status 1 if it does.
+ */
+
+static long allocations = 0;
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main (int argc, char *argv[]) {
+
+    GeneratorOptions options;
+    options.operations = argc > 1 ? atol(argv[1]) : 100000;
+    std::ostringstream out;
+    Generator(options).generate(out);
+    std::string block = out.str();
+
+    Diagnostics diagnostics;
+    Scanner scanner (block.data(), block.size(), 1, diagnostics);
+
+    long before = allocations;
+    long tokens = 0;
+    while (scanner.nextToken().category != Category::CAT_EOF) {
+        tokens++;
+    }
+    long scanning = allocations - before;
+
+    printf("%ld tokens, %ld allocations while scanning\n", tokens, scanning);
+    return scanning == 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#include "Generator.hpp"
+#include <Scanner.hpp>
+#include <Parser.hpp>
+#include <Renamer.hpp>
+#include <Scheduler.hpp>
+#include <Diagnostics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Per-phase microbenchmark. For each block size a block is generated, then
+ * scanning, parsing (which includes scanning), renaming, dependence graph
+ * construction, priority computation and list scheduling are timed on their
+ * own. Small blocks are repeated until each phase has run for a while. The
+ * report ends with the log-log scaling exponent of every phase, which should
+ * stay close to 1; anything well above it is flagged. The number of
+ * dependence edges per operation should stay small and flat as well.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+enum Phase { SCAN, PARSE, RENAME, GRAPH, PRIORITIES, SCHEDULE, NUM_PHASES };
+
+const char* PhaseNames[NUM_PHASES] = {"scan", "parse", "rename", "graph", "priorities", "schedule"};
+
+struct Sample {
+    long operations;
+    double bytes;
+    double edges;
+    double seconds[NUM_PHASES];
+};
+
+double elapsed(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+Sample measure(const std::string& filename, long operations, double minSeconds) {
+
+    Sample sample = {operations, 0, 0, {0}};
+    std::ifstream size(filename, std::ios::ate | std::ios::binary);
+    sample.bytes = size.tellg();
+
+    int repeats = 0;
+    double total = 0;
+    while (repeats == 0 || total < minSeconds) {
+        Diagnostics diagnostics;
+
+        Clock::time_point start = Clock::now();
+        Scanner tokens(filename, diagnostics);
+        while (tokens.nextToken().category != Category::CAT_EOF) {}
+        sample.seconds[SCAN] += elapsed(start);
+
+        start = Clock::now();
+        Scanner scanner(filename, diagnostics);
+        Parser parser(scanner, diagnostics);
+        InternalRepresentation rep = parser.parse();
+        sample.seconds[PARSE] += elapsed(start);
+
+        start = Clock::now();
+        Renamer().rename(rep);
+        sample.seconds[RENAME] += elapsed(start);
+
+        Scheduler scheduler;
+        start = Clock::now();
+        DependenceGraph graph = scheduler.buildDependenceGraph(rep);
+        sample.seconds[GRAPH] += elapsed(start);
+        sample.edges = (double) graph.numEdges() / std::max(graph.numNodes(), 1);
+
+        start = Clock::now();
+        std::vector<int> priorities = scheduler.getPriorities(graph);
+        sample.seconds[PRIORITIES] += elapsed(start);
+
+        start = Clock::now();
+        Schedule schedule = scheduler.listSchedule(graph, priorities);
+        sample.seconds[SCHEDULE] += elapsed(start);
+
+        repeats++;
+        total = 0;
+        for (int p = 0; p < NUM_PHASES; p++) {
+            total += sample.seconds[p];
+        }
+    }
+
+    for (int p = 0; p < NUM_PHASES; p++) {
+        sample.seconds[p] /= repeats;
+    }
+    return sample;
+}
+
+// Least-squares slope of log(time) against log(size)
+double exponent(const std::vector<Sample>& samples, int phase) {
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (const Sample& s : samples) {
+        if (s.seconds[phase] <= 0) {
+            continue;
+        }
+        double x = std::log((double) s.operations);
+        double y = std::log(s.seconds[phase]);
+        n++; sx += x; sy += y; sxx += x * x; sxy += x * y;
+    }
+    if (n < 2) {
+        return 0;
+    }
+    return (n * sxy - sx * sy) / (n * sxx - sx * sx);
+}
+
+int main (int argc, char *argv[]) {
+
+    long minSize = 100;
+    long maxSize = 10000000;
+    double minSeconds = 0.2;
+    std::string directory = "build/bench";
+    GeneratorOptions options;
+
+    for (int arg = 1; arg + 1 < argc; arg += 2) {
+        if (!strcmp(argv[arg], "-min")) minSize = atol(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-max")) maxSize = atol(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-time")) minSeconds = atof(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-dir")) directory = argv[arg + 1];
+        else if (!strcmp(argv[arg], "-w")) options.width = atoi(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-d")) options.depth = atoi(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-m")) options.memoryRatio = atof(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-x")) options.multDensity = atof(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-r")) options.reuse = atoi(argv[arg + 1]);
+        else if (!strcmp(argv[arg], "-a")) options.slots = atoi(argv[arg + 1]);
+        else {
+            fprintf(stderr, "ERROR: Unknown option %s.\n", argv[arg]);
+            return -1;
+        }
+    }
+
+    printf("%10s", "ops");
+    for (int p = 0; p < NUM_PHASES; p++) {
+        printf(" %12s", PhaseNames[p]);
+    }
+    printf(" %12s %10s %9s\n", "total ops/s", "scan MB/s", "edges/op");
+
+    std::vector<Sample> samples;
+    for (long size = minSize; size <= maxSize; size *= 10) {
+
+        // Generate the block into a file, since the scanner reads files
+        std::string filename = directory + "/block_" + std::to_string(size) + ".i";
+        {
+            std::ofstream out(filename);
+            if (!out.is_open()) {
+                fprintf(stderr, "ERROR: Failed to write %s.\n", filename.c_str());
+                return -1;
+            }
+            options.operations = size;
+            Generator(options).generate(out);
+        }
+
+        Sample sample = measure(filename, size, minSeconds);
+        samples.push_back(sample);
+        std::remove(filename.c_str());
+
+        double total = 0;
+        printf("%10ld", size);
+        for (int p = 0; p < NUM_PHASES; p++) {
+            printf(" %10.3fms", sample.seconds[p] * 1e3);
+            total += p == SCAN ? 0 : sample.seconds[p];
+        }
+        printf(" %12.3g %10.1f %9.2f\n", size / total, sample.bytes / sample.seconds[SCAN] / 1e6, sample.edges);
+        fflush(stdout);
+    }
+
+    printf("\nscaling exponent (time ~ ops^k):\n");
+    for (int p = 0; p < NUM_PHASES; p++) {
+        double k = exponent(samples, p);
+        printf("%12s %6.2f%s\n", PhaseNames[p], k, k > 1.3 ? "  <-- superlinear" : "");
+    }
+
+    return 0;
+}
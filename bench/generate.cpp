@@ -0,0 +1,52 @@
+#include "Generator.hpp"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+void help () {
+   std::cout << "Command Syntax: generate [-n <ops>] [-w <width>] [-d <depth>] [-m <ratio>] [-x <ratio>] [-r <regs>] [-a <slots>] [-s <seed>]" << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n <ops>: Number of operations (default: 1000)." << std::endl;
+   std::cout << "   -w <width>: Number of independent dependence chains (default: 4)." << std::endl;
+   std::cout << "   -d <depth>: Operations per chain before it restarts (default: 16)." << std::endl;
+   std::cout << "   -m <ratio>: Fraction of memory operations (default: 0.25)." << std::endl;
+   std::cout << "   -x <ratio>: Fraction of arithmetic operations that are MULT (default: 0.1)." << std::endl;
+   std::cout << "   -r <regs>: Register reuse distance (default: 64)." << std::endl;
+   std::cout << "   -a <slots>: Store to <slots> constant addresses first, then load only through an unknown pointer (default: 0)." << std::endl;
+   std::cout << "   -s <seed>: Random seed (default: 1)." << std::endl;
+}
+
+int main (int argc, char *argv[]) {
+
+   GeneratorOptions options;
+
+   for (int arg = 1; arg < argc; arg++) {
+      if (!strcmp(argv[arg], "-h")) {
+         help();
+         return 0;
+      }
+      if (arg + 1 >= argc || argv[arg][0] != '-') {
+         std::cerr << "ERROR: Invalid argument " << argv[arg] << "." << std::endl;
+         return -1;
+      }
+      const char* value = argv[++arg];
+      switch (argv[arg - 1][1]) {
+         case 'n': options.operations = atol(value); break;
+         case 'w': options.width = atoi(value); break;
+         case 'd': options.depth = atoi(value); break;
+         case 'm': options.memoryRatio = atof(value); break;
+         case 'x': options.multDensity = atof(value); break;
+         case 'r': options.reuse = atoi(value); break;
+         case 'a': options.slots = atoi(value); break;
+         case 's': options.seed = strtoull(value, nullptr, 10); break;
+         default:
+            std::cerr << "ERROR: Unknown option " << argv[arg - 1] << "." << std::endl;
+            return -1;
+      }
+   }
+
+   std::ios::sync_with_stdio(false);
+   Generator(options).generate(std::cout);
+
+   return 0;
+}
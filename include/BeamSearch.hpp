@@ -0,0 +1,53 @@
+#pragma once
+
+#include <ScheduleSearch.hpp>
+#include <chrono>
+#include <vector>
+
+/*
+ * Lookahead scheduling by beam search over list-scheduling states.
+ *
+ * A state is a partial schedule: the operations issued so far, the cycle
+ * being filled and the earliest cycle each released operation can issue.
+ * Each step expands every state in the beam by one cycle, trying its
+ * BRANCHING best unit assignments (the greedy choice always among them), and
+ * keeps the beamWidth children with the lowest lower bound on the final
+ * length. Children that cannot beat the best known length are pruned.
+ *
+ * The search stops when the beam empties or a budget of explored states or
+ * wall time runs out, and only reports a schedule strictly shorter than the
+ * one it was asked to improve. Blocks of more than MAX_NODES operations are
+ * not searched, since every state holds per-operation tables.
+ */
+class BeamSearch : private ScheduleSearch {
+public:
+    static constexpr int DEFAULT_WIDTH = 8;
+    static constexpr int BRANCHING = 4;
+    static constexpr int MAX_NODES = 1 << 16;
+    static constexpr size_t MAX_LEAVES = 64;
+
+    BeamSearch(const DependenceGraph& graph, const std::vector<int>& priorities, const Machine& machine,
+               long maxStates, double maxMilliseconds, int beamWidth = DEFAULT_WIDTH);
+
+    // Look for a schedule of fewer than `cycles` cycles and store it in result
+    bool improve(int cycles, Schedule& result);
+
+    long statesExplored() const { return states; }
+
+private:
+    // pathBound counts the priority of the latest issued operation
+    struct State : SearchState {
+        int bound = 0;
+        std::vector<int> slots;
+    };
+
+    long maxStates;
+    double maxMilliseconds;
+    int beamWidth;
+    long states;
+    std::chrono::steady_clock::time_point start;
+
+    bool exhausted() const;
+    void expand(State& state, std::vector<State>& children);
+    void computeBound(State& state);
+};
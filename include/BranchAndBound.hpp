@@ -0,0 +1,68 @@
+#pragma once
+
+#include <ScheduleSearch.hpp>
+#include <ScheduleBound.hpp>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Exact scheduling by depth-first branch and bound.
+ *
+ * The search fills one cycle at a time and branches over every maximal set of
+ * ready operations the units can take in it, the greedy choice first. Units
+ * are pipelined, so moving an operation into an earlier cycle where a unit
+ * could take it delays nothing; some shortest schedule therefore never leaves
+ * such a unit idle, and maximal sets are enough. (Sets are maximal under
+ * CycleAssignment's placement, a bipartite matching that finds every fit.)
+ *
+ * A partial schedule is pruned when its lower bound cannot beat the best
+ * length found. The bound combines the latency-weighted path left from each
+ * unfinished operation with the issue slots it competes for: the units that
+ * can execute it (LOAD and STORE only on f0 for ILOC) and per-cycle opcode
+ * limits (one OUTPUT per cycle). A partial schedule that repeats a visited
+ * one (same operations issued, same operations in flight) at the same or a
+ * later cycle is pruned too.
+ *
+ * The search stops at a deadline and reports the best schedule found if it
+ * is shorter than the one it was asked to improve. proven() tells whether it
+ * ran to completion, in which case no shorter schedule exists.
+ */
+class BranchAndBound : private ScheduleSearch {
+public:
+    static constexpr int MAX_NODES = 1024;
+    static constexpr int MAX_CHILDREN = 1024;
+    static constexpr size_t MAX_VISITED = 1 << 18;
+
+    BranchAndBound(const DependenceGraph& graph, const std::vector<int>& priorities, const Machine& machine,
+                   double maxMilliseconds);
+
+    // Look for a schedule of fewer than `cycles` cycles and store it in result
+    bool improve(int cycles, Schedule& result);
+
+    long statesExplored() const { return states; }
+    bool proven() const { return complete; }
+
+private:
+    // pathBound counts the tail of the latest issued operation
+    using State = SearchState;
+
+    double maxMilliseconds;
+    long states;
+    bool complete;
+    int best;
+    int floor;
+    ScheduleBound bound;
+    const std::vector<int>& tail;
+    std::chrono::steady_clock::time_point start;
+
+    // Rows of the current partial schedule and of the best complete one
+    std::vector<int> path;
+    std::vector<int> bestPath;
+    std::unordered_map<std::string, int> visited;
+
+    bool exhausted() const;
+    void search(State& state);
+    bool seen(const State& state);
+};
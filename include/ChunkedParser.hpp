@@ -0,0 +1,32 @@
+#pragma once
+
+#include <InputBuffer.hpp>
+#include <InternalRepresentation.hpp>
+#include <Diagnostics.hpp>
+#include <ThreadPool.hpp>
+
+/*
+ * Parallel front end. ILOC has no state across lines, so the input is split
+ * into chunks at newline boundaries and each chunk is scanned and parsed on
+ * the thread pool with its own Parser. The per-chunk operations, register
+ * maps and diagnostics are then merged in input order, which yields exactly
+ * the representation and error messages of a sequential parse (apart from
+ * where an error cap cuts the messages off).
+ */
+class ChunkedParser {
+public:
+    static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+    ChunkedParser(const InputBuffer& input, Diagnostics& diagnostics, ThreadPool& pool, int maxErrors = Diagnostics::UNLIMITED)
+        : input(input), diagnostics(diagnostics), pool(pool), maxErrors(maxErrors), tokens(0) {}
+
+    InternalRepresentation parse();
+    long tokenCount() const { return tokens; }
+
+private:
+    const InputBuffer& input;
+    Diagnostics& diagnostics;
+    ThreadPool& pool;
+    int maxErrors;
+    long tokens;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <ostream>
+
+/*
+ * Buffered collector for scanner and parser errors. Messages are formatted
+ * into a single string and written out in one call by flush(). Once
+ * maxErrors errors have been recorded (0 means no limit) the collector is
+ * full and callers are expected to stop.
+ */
+class Diagnostics {
+public:
+    static constexpr int UNLIMITED = 0;
+
+    Diagnostics(int maxErrors = UNLIMITED) : maxErrors(maxErrors), errors(0) {}
+
+    // ERROR <line>: <message>
+    void error(int line, std::string_view message);
+
+    // ERROR <line>: "<word>" <message>
+    void error(int line, std::string_view word, std::string_view message);
+
+    // Append the errors collected by another Diagnostics, up to this one's cap
+    void merge(const Diagnostics& other);
+
+    int count() const { return errors; }
+    bool full() const { return maxErrors != UNLIMITED && errors >= maxErrors; }
+    void flush(std::ostream& out);
+
+private:
+    int maxErrors;
+    int errors;
+    std::string buffer;
+
+    bool begin(int line);
+};
@@ -1,52 +1,180 @@
 #pragma once
 
-#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
 #include <vector>
-#include <memory>
 
+/*
+ * Directed graph in compressed sparse row (CSR) form.
+ *
+ * Node ids are dense: 1..numNodes() are real nodes and UNDEFINED_ID (0) is a
+ * sentinel. Edges are staged with addEdge() and packed into contiguous
+ * per-node in/out arrays by finalize(), which also merges duplicate edges
+ * (keeping the largest weight). Edge ranges may only be read after finalize().
+ */
 template<typename T>
 class Graph {
 public:
+    using Weight = uint8_t;
+
     struct Edge {
         int to;
-        int weight;
-        
-        Edge(int to, int weight) : to(to), weight(weight) {}
+        Weight weight;
     };
 
-    struct Node {
-        int id;
-        T data;
-        std::vector<Edge> inEdges;
-        std::vector<Edge> outEdges;
-        
-        Node(int id, const T& data) : id(id), data(data) {}
+    // Contiguous view over the in or out edges of a single node
+    class EdgeRange {
+    public:
+        class Iterator {
+        public:
+            Iterator(const int* to, const Weight* weight) : to(to), weight(weight) {}
+            Edge operator*() const { return {*to, *weight}; }
+            Iterator& operator++() { ++to; ++weight; return *this; }
+            bool operator!=(const Iterator& other) const { return to != other.to; }
+
+        private:
+            const int* to;
+            const Weight* weight;
+        };
+
+        EdgeRange(const int* to, const Weight* weight, int count) : to(to), weight(weight), count(count) {}
+        Iterator begin() const { return {to, weight}; }
+        Iterator end() const { return {to + count, weight + count}; }
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+
+    private:
+        const int* to;
+        const Weight* weight;
+        int count;
     };
 
-private:
-    int nextId;
-    
-public:
-    static constexpr int UNDEFINED_ID = -1;
-    std::unordered_map<int, std::unique_ptr<Node>> nodes;
-    
-    Graph() : nextId(1) {
-        nodes[UNDEFINED_ID] = std::make_unique<Node>(UNDEFINED_ID, T());
-    }
+    static constexpr int UNDEFINED_ID = 0;
+
+    Graph() : nodes(1) {}
 
     int getUndefined() const {
         return UNDEFINED_ID;
     }
 
+    int numNodes() const {
+        return nodes.size() - 1;
+    }
+
+    int numEdges() const {
+        return outTo.size();
+    }
+
+    void reserve(int nodeCount, int edgeCount) {
+        nodes.reserve(nodeCount + 1);
+        staged.reserve(edgeCount);
+    }
+
     int addNode(const T& data) {
-        int id = nextId++;
-        nodes[id] = std::make_unique<Node>(id, data);
-        return id;
+        nodes.push_back(data);
+        return nodes.size() - 1;
     }
-    
+
     void addEdge(int from, int to, int weight) {
-        nodes[from]->outEdges.emplace_back(to, weight);
-        nodes[to]->inEdges.emplace_back(from, weight);
+        staged.push_back({from, to, (Weight) weight});
+    }
+
+    T& operator[](int id) {
+        return nodes[id];
     }
-};
 
+    const T& operator[](int id) const {
+        return nodes[id];
+    }
+
+    EdgeRange outEdges(int id) const {
+        return {outTo.data() + outStart[id], outWeight.data() + outStart[id], outStart[id + 1] - outStart[id]};
+    }
+
+    EdgeRange inEdges(int id) const {
+        return {inTo.data() + inStart[id], inWeight.data() + inStart[id], inStart[id + 1] - inStart[id]};
+    }
+
+    // Pack staged edges into CSR arrays, merging duplicates
+    void finalize() {
+        int n = nodes.size();
+
+        // Bucket staged edges by source, preserving insertion order
+        std::vector<int> start(n + 1, 0);
+        for (const StagedEdge& e : staged) {
+            start[e.from + 1]++;
+        }
+        for (int i = 0; i < n; i++) {
+            start[i + 1] += start[i];
+        }
+        std::vector<int> bucketTo(staged.size());
+        std::vector<Weight> bucketWeight(staged.size());
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (const StagedEdge& e : staged) {
+            bucketTo[fill[e.from]] = e.to;
+            bucketWeight[fill[e.from]++] = e.weight;
+        }
+        staged.clear();
+        staged.shrink_to_fit();
+
+        // Merge duplicate edges within each source, keeping the first position
+        // and the largest weight
+        std::vector<int> seen(n, -1);
+        outStart.assign(n + 1, 0);
+        outTo.clear();
+        outWeight.clear();
+        outTo.reserve(bucketTo.size());
+        outWeight.reserve(bucketTo.size());
+        std::vector<int> inCount(n + 1, 0);
+        for (int from = 0; from < n; from++) {
+            outStart[from] = outTo.size();
+            for (int i = start[from]; i < start[from + 1]; i++) {
+                int to = bucketTo[i];
+                if (seen[to] >= outStart[from]) {
+                    Weight& w = outWeight[seen[to]];
+                    w = std::max(w, bucketWeight[i]);
+                    continue;
+                }
+                seen[to] = outTo.size();
+                outTo.push_back(to);
+                outWeight.push_back(bucketWeight[i]);
+                inCount[to + 1]++;
+            }
+        }
+        outStart[n] = outTo.size();
+
+        // Build reverse (in) edges from the merged out edges
+        for (int i = 0; i < n; i++) {
+            inCount[i + 1] += inCount[i];
+        }
+        inStart = inCount;
+        inTo.resize(outTo.size());
+        inWeight.resize(outTo.size());
+        std::vector<int> inFill(inStart.begin(), inStart.end() - 1);
+        for (int from = 0; from < n; from++) {
+            for (int i = outStart[from]; i < outStart[from + 1]; i++) {
+                int slot = inFill[outTo[i]]++;
+                inTo[slot] = from;
+                inWeight[slot] = outWeight[i];
+            }
+        }
+    }
+
+private:
+    struct StagedEdge {
+        int from;
+        int to;
+        Weight weight;
+    };
+
+    std::vector<T> nodes;
+    std::vector<StagedEdge> staged;
+
+    std::vector<int> outStart;
+    std::vector<int> outTo;
+    std::vector<Weight> outWeight;
+
+    std::vector<int> inStart;
+    std::vector<int> inTo;
+    std::vector<Weight> inWeight;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <exception>
+
+class FileNotFoundException : public std::exception {
+public:
+    FileNotFoundException(const std::string& msg) : message(msg) {}
+    const char* what() const noexcept override {
+        return message.c_str();
+    }
+
+private:         
+    std::string message;
+};
+
+/*
+ * Read-only view of a whole input file. Regular files are memory-mapped and
+ * scanned in place. Pipes and other streams, or files whose last line has no
+ * terminating newline, are read into an owned buffer instead. In both cases
+ * the contents are guaranteed to end with '\n' unless the input is empty.
+ */
+class InputBuffer {
+public:
+    InputBuffer(const std::string& filename);
+    ~InputBuffer();
+
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+    bool isMapped() const { return mapped != nullptr; }
+
+private:
+    void* mapped;
+    size_t mappedLength;
+    std::string buffer;
+    const char* begin;
+    size_t length;
+
+    void readStream(int fd);
+};
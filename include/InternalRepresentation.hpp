@@ -8,4 +8,8 @@ struct InternalRepresentation {
     int maxSR = -1;
     int maxVR = -1;
     int maxLive = -1;
+
+    // Register operands are compacted by the parser: SR is a dense index and
+    // registerNames[SR] is the register number written in the input
+    std::vector<int> registerNames;
 };
\ No newline at end of file
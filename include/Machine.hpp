@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Opcode.hpp>
+#include <cstdint>
+#include <string>
+#include <exception>
+#include <vector>
+
+class MachineDescriptionException : public std::exception {
+public:
+    MachineDescriptionException(const std::string& msg) : message(msg) {}
+    const char* what() const noexcept override {
+        return message.c_str();
+    }
+
+private:         
+    std::string message;
+};
+
+/*
+ * Target machine model: how many operations issue per cycle, which opcodes
+ * each functional unit can execute, the latency of every opcode and how many
+ * operations of an opcode may issue in one cycle. A default-constructed
+ * Machine is the two-unit ILOC target: loads and stores only on unit 0,
+ * multiplies only on unit 1 and at most one output per cycle.
+ *
+ * Machine::load() reads a description file, one directive per line, starting
+ * from the ILOC target:
+ *
+ *     width <n>                    units issued per cycle (1..MAX_WIDTH)
+ *     unit <i> <opcode> ...        opcodes unit i can execute
+ *     latency <opcode> <cycles>    cycles until the result is available
+ *     limit <opcode> <count>       operations of the opcode per cycle
+ *
+ * Units 0 and 1 default to their ILOC capabilities and any further unit to
+ * every opcode. Every unit can execute nop, listed or not. Text after "//" or "#" is a comment.
+ */
+struct Machine {
+    static constexpr int MAX_WIDTH = 8;
+    static constexpr int NUM_OPCODES = 10;
+    static constexpr int MAX_LATENCY = 255;
+
+    // Bit (1 << opcode) is set when a unit can execute the opcode
+    using OpcodeMask = uint16_t;
+    static constexpr OpcodeMask ALL_OPCODES = (1 << NUM_OPCODES) - 1;
+
+    static constexpr OpcodeMask mask(Opcode opcode) {
+        return 1 << (int) opcode;
+    }
+
+    // Opcodes sharing at most `capacity` issue slots per cycle, on `units`
+    struct Resource {
+        OpcodeMask opcodes;
+        unsigned units;
+        int capacity;
+    };
+
+    int width;
+    OpcodeMask units[MAX_WIDTH] = {};
+    int latency[NUM_OPCODES] = {};
+    int limit[NUM_OPCODES] = {};
+
+    constexpr Machine() : width(2) {
+        units[0] = ALL_OPCODES & ~mask(Opcode::MULT);
+        units[1] = ALL_OPCODES & ~mask(Opcode::LOAD) & ~mask(Opcode::STORE);
+        for (int u = 2; u < MAX_WIDTH; u++) {
+            units[u] = ALL_OPCODES;
+        }
+        for (int i = 0; i < NUM_OPCODES; i++) {
+            latency[i] = Latency[i];
+            limit[i] = MAX_WIDTH;
+        }
+        limit[(int) Opcode::OUTPUT] = 1;
+    }
+
+    constexpr bool canRun(int unit, Opcode opcode) const {
+        return units[unit] & mask(opcode);
+    }
+
+    // Bit u is set when unit u can execute the opcode
+    constexpr unsigned unitsFor(Opcode opcode) const {
+        unsigned result = 0;
+        for (int u = 0; u < width; u++) {
+            result |= canRun(u, opcode) << u;
+        }
+        return result;
+    }
+
+    constexpr int maxLatency() const {
+        int result = 1;
+        for (int i = 0; i < NUM_OPCODES; i++) {
+            result = result > latency[i] ? result : latency[i];
+        }
+        return result;
+    }
+
+    // Issue slots that limit how fast a block can run: every set of units
+    // that is exactly the units able to execute some opcodes (f0 for LOAD
+    // and STORE on ILOC, f1 for MULT, both units for everything), and every
+    // opcode limited to fewer operations per cycle than its units could
+    // issue (one OUTPUT per cycle)
+    std::vector<Resource> resources() const;
+
+    static Machine load(const std::string& filename);
+};
@@ -52,4 +52,6 @@ const int Latency[10] = {
     1, // RSHIFT
     1, // OUTPUT
     1  // NOP
-};
\ No newline at end of file
+};
+
+const int MAX_LATENCY = 6;
\ No newline at end of file
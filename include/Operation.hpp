@@ -2,7 +2,9 @@
 
 #include <Opcode.hpp>
 #include <string>
+#include <charconv>
 #include <stdexcept>
+#include <vector>
 
 struct Operand {
     int SR = -1;
@@ -17,70 +19,119 @@ struct Operation {
     Operand op2;
     Operand op3;
 
-    std::string printIR() const {
+    // Collect the register operands read by this operation (at most two)
+    int getUses(Operand* uses[2]) {
         switch (this->opcode) {
-            case Opcode::LOAD: 
-            case Opcode::STORE: 
-                return OpcodeNamesPadded[(int) opcode] + " [ sr" + std::to_string(op1.SR) + " ]," + " [ ]," + " [ sr" + std::to_string(op3.SR) + " ]";
-            case Opcode::LOADI:
-                return OpcodeNamesPadded[(int) opcode] + " [ val " + std::to_string(op1.SR) + " ]," + " [ ]," + " [ sr" + std::to_string(op3.SR) + " ]";
-            case Opcode::ADD: 
+            case Opcode::LOAD:
+                uses[0] = &op1;
+                return 1;
+            case Opcode::STORE:
+                uses[0] = &op1;
+                uses[1] = &op3;
+                return 2;
+            case Opcode::ADD:
             case Opcode::SUB:
-            case Opcode::MULT: 
-            case Opcode::LSHIFT: 
-            case Opcode::RSHIFT: 
-                return OpcodeNamesPadded[(int) opcode] + " [ sr" + std::to_string(op1.SR) + " ]," + " [ sr" + std::to_string(op2.SR) + " ]," + " [ sr" + std::to_string(op3.SR) + " ]";
-            case Opcode::OUTPUT:
-                return OpcodeNamesPadded[(int) opcode] + " [ val " + std::to_string(op1.SR) + " ]," + " [ ]," + " [ ]";
-            case Opcode::NOP: 
-                return OpcodeNamesPadded[(int) opcode] + " [ ]," + " [ ]," + " [ ]";
+            case Opcode::MULT:
+            case Opcode::LSHIFT:
+            case Opcode::RSHIFT:
+                uses[0] = &op1;
+                uses[1] = &op2;
+                return 2;
             default:
-                throw std::invalid_argument("Operation has invalid opcode.");
+                return 0;
         }
     }
 
+    std::string printIR(const std::vector<int>& registerNames) const {
+        std::string out;
+        appendIR(out, registerNames);
+        return out;
+    }
+
     std::string printVR() const {
+        std::string out;
+        appendVR(out);
+        return out;
+    }
+
+    std::string printPR() const {
+        std::string out;
+        appendPR(out);
+        return out;
+    }
+
+    // Append the printed form to a buffer without temporary strings. SR fields
+    // hold the parser's dense register indices, so the IR prints
+    // registerNames[SR], the register number written in the input.
+    void appendIR(std::string& out, const std::vector<int>& registerNames) const {
+        out += OpcodeNamesPadded[(int) opcode];
         switch (this->opcode) {
             case Opcode::LOAD: 
             case Opcode::STORE: 
-                return OpcodeNamesPadded[(int) opcode] + "r" + std::to_string(op1.VR) + " => r" + std::to_string(op3.VR);
+                out += " [ sr"; appendInt(out, registerNames[op1.SR]); out += " ], [ ], [ sr"; appendInt(out, registerNames[op3.SR]); out += " ]";
+                break;
             case Opcode::LOADI:
-                return OpcodeNamesPadded[(int) opcode] + std::to_string(op1.SR) + " => r" + std::to_string(op3.VR);
+                out += " [ val "; appendInt(out, op1.SR); out += " ], [ ], [ sr"; appendInt(out, registerNames[op3.SR]); out += " ]";
+                break;
             case Opcode::ADD: 
             case Opcode::SUB:
             case Opcode::MULT: 
             case Opcode::LSHIFT: 
             case Opcode::RSHIFT: 
-                return OpcodeNamesPadded[(int) opcode] + "r" + std::to_string(op1.VR) + ", r" + std::to_string(op2.VR) + " => r" + std::to_string(op3.VR);
+                out += " [ sr"; appendInt(out, registerNames[op1.SR]); out += " ], [ sr"; appendInt(out, registerNames[op2.SR]); out += " ], [ sr"; appendInt(out, registerNames[op3.SR]); out += " ]";
+                break;
             case Opcode::OUTPUT:
-                return OpcodeNamesPadded[(int) opcode] + std::to_string(op1.SR);
+                out += " [ val "; appendInt(out, op1.SR); out += " ], [ ], [ ]";
+                break;
             case Opcode::NOP: 
-                return OpcodeNamesPadded[(int) opcode];
+                out += " [ ], [ ], [ ]";
+                break;
             default:
                 throw std::invalid_argument("Operation has invalid opcode.");
         }
     }
 
-    std::string printPR() const {
+    void appendVR(std::string& out) const {
+        appendRegisters(out, op1.VR, op2.VR, op3.VR);
+    }
+
+    void appendPR(std::string& out) const {
+        appendRegisters(out, op1.PR, op2.PR, op3.PR);
+    }
+
+private:
+    static void appendInt(std::string& out, int value) {
+        char digits[16];
+        auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, end - digits);
+    }
+
+    void appendRegisters(std::string& out, int r1, int r2, int r3) const {
+        out += OpcodeNamesPadded[(int) opcode];
         switch (this->opcode) {
             case Opcode::LOAD: 
             case Opcode::STORE: 
-                return OpcodeNamesPadded[(int) opcode] + "r" + std::to_string(op1.PR) + " => r" + std::to_string(op3.PR);
+                out += "r"; appendInt(out, r1); out += " => r"; appendInt(out, r3);
+                break;
             case Opcode::LOADI:
-                return OpcodeNamesPadded[(int) opcode] + std::to_string(op1.SR) + " => r" + std::to_string(op3.PR);
+                appendInt(out, op1.SR); out += " => r"; appendInt(out, r3);
+                break;
             case Opcode::ADD: 
             case Opcode::SUB:
             case Opcode::MULT: 
             case Opcode::LSHIFT: 
             case Opcode::RSHIFT: 
-                return OpcodeNamesPadded[(int) opcode] + "r" + std::to_string(op1.PR) + ", r" + std::to_string(op2.PR) + " => r" + std::to_string(op3.PR);
+                out += "r"; appendInt(out, r1); out += ", r"; appendInt(out, r2); out += " => r"; appendInt(out, r3);
+                break;
             case Opcode::OUTPUT:
-                return OpcodeNamesPadded[(int) opcode] + std::to_string(op1.SR);
+                appendInt(out, op1.SR);
+                break;
             case Opcode::NOP: 
-                return OpcodeNamesPadded[(int) opcode];
+                break;
             default:
                 throw std::invalid_argument("Operation has invalid opcode.");
         }
     }
 };
 
+const Operation NOP_OPERATION = {Opcode::NOP, {}, {}, {}};
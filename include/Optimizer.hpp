@@ -0,0 +1,68 @@
+#pragma once
+
+#include <InternalRepresentation.hpp>
+#include <Stats.hpp>
+#include <climits>
+#include <cstdint>
+
+/*
+ * Optional cleanup of a parsed block before it is renamed and scheduled (-c).
+ *
+ * A forward pass tracks the registers that hold known constants and rewrites
+ * arithmetic on two of them as a loadI of the result, so chains of constant
+ * arithmetic fold into one loadI. A backward pass then removes loadI and
+ * arithmetic operations whose result has no next use, the same liveness the
+ * renamer computes; a removed operation's operands may die in turn, so whole
+ * dead chains go in one pass. Loads, stores and outputs are never removed or
+ * rewritten, so memory and output are unchanged.
+ *
+ * The cleanup works on source registers, so renaming afterwards gives the
+ * cleaned block dense VRs, next uses and MaxLive for either front end.
+ */
+class Optimizer {
+public:
+    static constexpr int64_t UNKNOWN = INT64_MIN;
+
+    Optimizer(Stats* stats = nullptr) : stats(stats) {}
+
+    // Fold and remove dead operations, returns how many were removed. Throws
+    // RenamingFailedException if the block uses an undefined register.
+    long optimize(InternalRepresentation& rep);
+
+    // The value of an arithmetic operation on two known values, or UNKNOWN
+    // when either is unknown or the exact result does not fit in 32 bits
+    static int64_t fold(Opcode opcode, int64_t a, int64_t b) {
+        if (a == UNKNOWN || b == UNKNOWN) {
+            return UNKNOWN;
+        }
+        int64_t result = UNKNOWN;
+        switch (opcode) {
+            case Opcode::ADD:
+                result = a + b;
+                break;
+            case Opcode::SUB:
+                result = a - b;
+                break;
+            case Opcode::MULT:
+                result = a * b;
+                break;
+            case Opcode::LSHIFT:
+                if (b >= 0 && b < 32) {
+                    result = a * ((int64_t) 1 << b);
+                }
+                break;
+            case Opcode::RSHIFT:
+                // Logical and arithmetic shifts only agree on non-negative values
+                if (a >= 0 && b >= 0 && b < 32) {
+                    result = a >> b;
+                }
+                break;
+            default:
+                break;
+        }
+        return result < INT32_MIN || result > INT32_MAX ? UNKNOWN : result;
+    }
+
+private:
+    Stats* stats;
+};
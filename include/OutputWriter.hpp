@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Operation.hpp>
+#include <ostream>
+#include <string>
+
+/*
+ * Buffered writer for schedules. Cycles are formatted straight into one
+ * reusable buffer, which is written to the stream in large chunks rather
+ * than flushed line by line.
+ */
+class OutputWriter {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+    OutputWriter(std::ostream& out, size_t capacity = DEFAULT_CAPACITY) : out(out), capacity(capacity) {
+        buffer.reserve(capacity + 256);
+    }
+
+    ~OutputWriter() {
+        flush();
+    }
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    // [ <op0> ; <op1> ; ... ]
+    void writeCycle(const Operation* ops, int width) {
+        buffer += "[ ";
+        for (int u = 0; u < width; u++) {
+            if (u > 0) {
+                buffer += " ; ";
+            }
+            ops[u].appendVR(buffer);
+        }
+        buffer += " ]\n";
+        if (buffer.size() >= capacity) {
+            drain();
+        }
+    }
+
+    void flush() {
+        drain();
+        out.flush();
+    }
+
+private:
+    std::ostream& out;
+    size_t capacity;
+    std::string buffer;
+
+    void drain() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+};
@@ -1,25 +1,12 @@
 #pragma once
 
 #include <Scanner.hpp>
+#include <Diagnostics.hpp>
 #include <InternalRepresentation.hpp>
+#include <RegisterMap.hpp>
 #include <string>
 #include <exception>
 
-class InvalidTokenException : public std::exception {
-public:
-    InvalidTokenException(Token t, const std::string& msg) : token(t), message(msg) {}
-    const char* what() const noexcept override {
-        return message.c_str();
-    }
-    Token getToken() const {
-        return token;
-    }
-
-private:
-    Token token;          
-    std::string message;
-};
-
 class ParseFailedException : public std::exception {
 public:
     ParseFailedException(const std::string& msg) : message(msg) {}
@@ -31,30 +18,29 @@ private:
     std::string message;
 };
 
-class UnexpectedEOFException : public std::exception {
-public:
-    UnexpectedEOFException(const std::string& msg) : message(msg) {}
-    const char* what() const noexcept override {
-        return message.c_str();
-    }
-
-private:         
-    std::string message;
+enum class ParseStatus {
+    OK,
+    ERROR,
+    UNEXPECTED_EOF
 };
 
 class Parser {
 public:
-    Parser(Scanner& scanner) : scanner(scanner), line (0) {}
+    Parser(Scanner& scanner, Diagnostics& diagnostics, int firstLine = 1) : scanner(scanner), diagnostics(diagnostics), line (firstLine - 1), errors(0) {}
     InternalRepresentation parse();
+    int errorCount() const { return errors; }
 
 private:
     Scanner& scanner;
+    Diagnostics& diagnostics;
+    RegisterMap registers;
     int line;
-    Operation finishMEMOP(Opcode opcode);
-    Operation finishLOADI(Opcode opcode);
-    Operation finishARITHOP(Opcode opcode);
-    Operation finishOUTPUT(Opcode opcode);
-    Operation finishNOP(Opcode opcode);
-    void readToNextLine();
-    void handleInvalidToken(const InvalidTokenException& e);
-};
\ No newline at end of file
+    int errors;
+    ParseStatus finishMEMOP(Operation& op);
+    ParseStatus finishLOADI(Operation& op);
+    ParseStatus finishARITHOP(Operation& op);
+    ParseStatus finishOUTPUT(Operation& op);
+    ParseStatus finishNOP(Operation& op);
+    ParseStatus readToNextLine();
+    ParseStatus invalidToken(const Token& token, const char* message);
+};
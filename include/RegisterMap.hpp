@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Maps source register numbers to a dense range 0..size() - 1, in order of
+ * first appearance. Small register numbers are looked up in a direct table
+ * that grows on demand; numbers beyond DIRECT_LIMIT go through a hash map, so
+ * memory stays proportional to the number of distinct registers however
+ * sparse their numbering is.
+ */
+class RegisterMap {
+public:
+    static constexpr int DIRECT_LIMIT = 1 << 16;
+
+    int index(int reg) {
+        if (reg < DIRECT_LIMIT) {
+            if (reg >= (int) direct.size()) {
+                direct.resize(std::min(std::max(reg + 1, 2 * (int) direct.size()), DIRECT_LIMIT), -1);
+            }
+            int& slot = direct[reg];
+            if (slot == -1) {
+                slot = add(reg);
+            }
+            return slot;
+        }
+
+        auto [it, inserted] = sparse.try_emplace(reg, 0);
+        if (inserted) {
+            it->second = add(reg);
+        }
+        return it->second;
+    }
+
+    int size() const {
+        return registers.size();
+    }
+
+    // Original register number of each dense index
+    const std::vector<int>& names() const {
+        return registers;
+    }
+
+private:
+    std::vector<int> direct;
+    std::unordered_map<int, int> sparse;
+    std::vector<int> registers;
+
+    int add(int reg) {
+        registers.push_back(reg);
+        return registers.size() - 1;
+    }
+};
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <InternalRepresentation.hpp>
+#include <ThreadPool.hpp>
+#include <algorithm>
 #include <string>
 #include <exception>
+#include <vector>
 
 class RenamingFailedException : public std::exception {
 public:
@@ -15,7 +18,86 @@ private:
     std::string message;
 };
 
+// Backward renaming state. SRToVR and LU are per-register tables (SRs are
+// dense after parsing); LU[SR] is -1 exactly when SR is not live.
+struct RenameState {
+    std::vector<int> SRToVR;
+    std::vector<int> LU;
+    int VRName = 0;
+    int live = 0;
+    int maxLive = 0;
+
+    // When tracking, firstName[SR] is the first name handed to SR and touched
+    // lists every register seen, in that order
+    bool track = false;
+    std::vector<int> firstName;
+    std::vector<int> touched;
+
+    RenameState(int registers) : SRToVR(registers, -1), LU(registers, -1) {}
+
+    void allocate(int SR) {
+        if (track && firstName[SR] == -1) {
+            firstName[SR] = VRName;
+            touched.push_back(SR);
+        }
+        SRToVR[SR] = VRName++;
+        live++;
+    }
+};
+
 class Renamer {
 public:
+    static constexpr const char* UNDEFINED_USE = "Input block uses values from registers that have no prior definition.";
+
+    // Blocks of at least two segments of this many operations are renamed in
+    // parallel when a pool is given; the result is identical to a serial sweep
+    static constexpr long MIN_SEGMENT_SIZE = 1 << 16;
+
+    Renamer(ThreadPool* pool = nullptr) : pool(pool) {}
     void rename(InternalRepresentation& rep);
-};
\ No newline at end of file
+
+    // One step of the backward sweep: rename the operation at the given
+    // 1-based index, with the state describing everything below it
+    static void renameOperation(Operation& op, int index, RenameState& state) {
+
+        std::vector<int>& SRToVR = state.SRToVR;
+        std::vector<int>& LU = state.LU;
+
+        Operand& o = op.op3;
+        if (op.opcode != Opcode::STORE && o.SR != -1) {
+            if (SRToVR[o.SR] == -1) {
+                state.allocate(o.SR);
+            }
+            o.VR = SRToVR[o.SR];
+            o.NU = LU[o.SR];
+            SRToVR[o.SR] = -1;
+            LU[o.SR]= -1;
+            state.live --;
+        }
+
+        Operand* uses[2];
+        int numUses = op.getUses(uses);
+
+        for (int i = 0; i < numUses; i++) {
+            Operand* o = uses[i];
+            if (SRToVR[o->SR] == -1) {
+                state.allocate(o->SR);
+            }
+            o->VR = SRToVR[o->SR];
+            o->NU = LU[o->SR];
+        }
+
+        for (int i = 0; i < numUses; i++) {
+            LU[uses[i]->SR] = index;
+        }
+
+        state.maxLive = std::max(state.maxLive, state.live);
+    }
+
+    // Check that nothing is live on entry and record maxVR and maxLive
+    static void finish(InternalRepresentation& rep, const RenameState& state);
+
+private:
+    ThreadPool* pool;
+    void renameParallel(InternalRepresentation& rep, int segments);
+};
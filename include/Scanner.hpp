@@ -2,34 +2,33 @@
 
 #include <Token.hpp>
 #include <TransitionTable.hpp>
-#include <fstream>
+#include <InputBuffer.hpp>
+#include <Diagnostics.hpp>
 #include <string>
-#include <exception>
+#include <cstddef>
+#include <memory>
 
 class Scanner {
 public:
-    Scanner(const std::string filename);
+    Scanner(const std::string filename, Diagnostics& diagnostics);
+
+    // Scan a range of an existing buffer. The range must be empty or end with
+    // '\n', and its first line is numbered firstLine in error messages.
+    Scanner(const char* begin, size_t size, int firstLine, Diagnostics& diagnostics);
+
     Token nextToken();
+    long tokenCount() const { return tokens; }
 
 private:
-    std::ifstream file;
-    TransitionTable table;
-    std::string buffer;
-    int index;
+    std::unique_ptr<InputBuffer> input;
+    Diagnostics& diagnostics;
+    const char* buffer;
+    size_t size;
+    size_t index;
     int line;
-    bool eof;
+    long tokens;
 
-    void readLine();
-    int getLexeme(Category category, int first);
+    size_t endOfLine(size_t from) const;
+    int getLexeme(Category category, size_t first);
+    int decodeNumber(size_t first, size_t last) const;
 };
-
-class FileNotFoundException : public std::exception {
-public:
-    FileNotFoundException(const std::string& msg) : message(msg) {}
-    const char* what() const noexcept override {
-        return message.c_str();
-    }
-
-private:         
-    std::string message;
-};
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ScheduleSearch.hpp>
+#include <vector>
+
+/*
+ * Lower bound on the length of any schedule that extends a partial one. Every
+ * operation left has a head, the earliest cycle its predecessors allow it to
+ * issue in, and a tail, the cycles it needs from issue to the end of the
+ * schedule.
+ *
+ * The path bound is the longest head plus tail, which for the empty schedule
+ * is the critical path of the block. Each resource bound covers the
+ * operations of one Machine::Resource (memory operations on f0, MULT on f1,
+ * one OUTPUT per cycle on ILOC): the k of them with the latest heads issue no
+ * earlier than the k-th latest head, take ceil(k / capacity) cycles of the
+ * resource, and the last of them still needs its tail.
+ *
+ * BranchAndBound prunes with it and ScheduleReport reports it for the empty
+ * schedule, so the reported bound is the one the search starts from.
+ */
+class ScheduleBound {
+public:
+    ScheduleBound(const DependenceGraph& graph, const Machine& machine);
+
+    // Lower bound for a partial schedule whose next cycle is state.cycle
+    int compute(const SearchState& state);
+
+    // Parts of the last bound computed
+    int pathBound() const { return path; }
+    int resourceBound(size_t r) const { return bounds[r]; }
+    long resourceOperations(size_t r) const { return demand[r].size(); }
+
+    const std::vector<Machine::Resource>& resources() const { return limited; }
+
+    // Cycles from the issue of each operation to the end of the schedule
+    const std::vector<int>& tails() const { return tail; }
+
+private:
+    const DependenceGraph& graph;
+    std::vector<Machine::Resource> limited;
+    std::vector<int> tail;
+    int path;
+    std::vector<int> bounds;
+
+    // Scratch space: heads, and (head, tail) per resource
+    std::vector<int> head;
+    std::vector<std::vector<std::pair<int, int>>> demand;
+};
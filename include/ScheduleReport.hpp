@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Scheduler.hpp>
+#include <Machine.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Quality of one schedule: lower bounds on the length of any schedule of the
+ * block, the gap between the schedule and the best bound, and how busy each
+ * unit is. --report prints it as one JSON object per block.
+ *
+ * The bounds are ScheduleBound's for the empty schedule: the critical path,
+ * the longest latency-weighted path through the dependence graph up to the
+ * cycle its last operation completes, and one per Machine::Resource. Their
+ * maximum is the bound BranchAndBound starts its search from.
+ */
+struct ScheduleReport {
+    struct ResourceBound {
+        Machine::Resource resource;
+        long operations;
+        int bound;
+    };
+
+    long operations = 0;
+    int cycles = 0;
+    int criticalPath = 0;
+    std::vector<ResourceBound> resources;
+    int lowerBound = 0;
+    long nopSlots = 0;
+    std::vector<double> utilization;
+
+    static ScheduleReport analyze(const DependenceGraph& graph, const Schedule& schedule, const Machine& machine);
+
+    int gap() const { return cycles - lowerBound; }
+
+    void print(std::ostream& out, const std::string& name) const;
+};
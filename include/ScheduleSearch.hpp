@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Scheduler.hpp>
+#include <Machine.hpp>
+#include <vector>
+
+/*
+ * A partial list schedule: the operations issued so far, the cycle being
+ * filled and the earliest cycle each released operation can issue.
+ */
+struct SearchState {
+    int cycle = 1;
+    int scheduled = 0;
+    int finish = 0;       // last cycle in which an issued operation executes
+    int pathBound = 0;    // latest issued operation plus its path to the end
+    std::vector<int> pending;
+    std::vector<int> earliest;
+    std::vector<int> ready;
+
+    // Nothing issued: leaves of the dependence graph are ready in cycle 1
+    static SearchState initial(const DependenceGraph& graph);
+};
+
+/*
+ * The moves shared by the schedule searches (BeamSearch, BranchAndBound).
+ * Both fill one cycle at a time from a SearchState, choosing among maximal
+ * unit assignments of the ready operations in the greedy scheduler's order.
+ * Rows of a partial schedule are kept as node ids per unit, 0 for idle.
+ */
+class ScheduleSearch {
+protected:
+    using Assignment = CycleAssignment<Machine::MAX_WIDTH>;
+
+    const DependenceGraph& graph;
+    const std::vector<int>& priorities;
+    const Machine& machine;
+    unsigned unitsFor[Machine::NUM_OPCODES];
+
+    ScheduleSearch(const DependenceGraph& graph, const std::vector<int>& priorities, const Machine& machine);
+
+    // Skip idle cycles until something can issue, padding rows with idle slots
+    void skipIdle(SearchState& state, std::vector<int>& rows) const;
+
+    // Ready operations that can issue this cycle, in the greedy scheduler's order
+    std::vector<int> candidates(const SearchState& state) const;
+
+    // Every maximal assignment of the candidates, the greedy one first and the
+    // rest by decreasing total priority. Only the first `branching`
+    // candidates may be left out when they fit, and at most maxLeaves
+    // assignments are found. Returns false if some were dropped.
+    bool assignments(const std::vector<int>& candidates, int branching, size_t maxLeaves,
+                     std::vector<Assignment>& result) const;
+
+    // Issue one cycle's assignment and move to the next cycle. An issued
+    // operation raises pathBound to its cycle plus tail[id].
+    void issueCycle(SearchState& state, const Assignment& units, const std::vector<int>& tail,
+                    std::vector<int>& rows) const;
+
+    // Turn rows into a schedule of `length` cycles, idling until the last
+    // operation completes
+    void materialise(const std::vector<int>& rows, int length, Schedule& result) const;
+
+    bool assigned(const Assignment& units, int id) const;
+};
@@ -2,21 +2,14 @@
 
 #include <InternalRepresentation.hpp>
 #include <Graph.hpp>
-#include <unordered_map>
+#include <Machine.hpp>
+#include <Stats.hpp>
 #include <queue>
 #include <vector>
 
 /* Dependence Graph and Related Types */
-enum class Status {
-    NOT_READY,
-    READY,
-    ACTIVE,
-    RETIRED
-};
-
 struct OperationData {
     Operation op;
-    Status status;
 };
 
 using DependenceGraph = Graph<OperationData>;
@@ -31,22 +24,210 @@ struct OperationPriority {
 
 struct CompareOperation {
     bool operator()(const OperationPriority& p1, const OperationPriority& p2) {
-        return p1.priority < p2.priority;
+        if (p1.priority != p2.priority) {
+            return p1.priority < p2.priority;
+        }
+        return p1.id > p2.id; // Break ties in program order
     }  
 };
 
 using OperationPriorityQueue = std::priority_queue<OperationPriority, std::vector<OperationPriority>, CompareOperation>;
 
+/* Retirement Timing Wheel */
+
+// Operations in flight, bucketed by the cycle in which they complete. The
+// wheel has more slots than the longest latency, so a slot is never shared
+// by two different completion cycles.
+class RetirementWheel {
+public:
+    RetirementWheel(int maxLatency = MAX_LATENCY) : mask(1), count(0) {
+        while (mask <= maxLatency) {
+            mask <<= 1;
+        }
+        slots.resize(mask);
+        mask--;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void insert(int cycle, int id) {
+        slots[cycle & mask].push_back(id);
+        count++;
+    }
+
+    // First cycle after the given one in which an operation completes
+    int nextEvent(int cycle) const {
+        int next = cycle + 1;
+        while (slots[next & mask].empty()) {
+            next++;
+        }
+        return next;
+    }
+
+    // Remove and return the operations completing in the given cycle
+    const std::vector<int>& take(int cycle) {
+        retired.clear();
+        retired.swap(slots[cycle & mask]);
+        count -= retired.size();
+        return retired;
+    }
+
+private:
+    int mask;
+    int count;
+    std::vector<std::vector<int>> slots;
+    std::vector<int> retired;
+};
+
+/* Unit Assignment */
+
+// Operations placed on the functional units in one cycle. An operation goes
+// to the first free unit that can execute it; failing that, operations
+// already placed are moved along an augmenting path until a capable unit is
+// free (on ILOC, an ADD moves from f0 to f1 to make room for a LOAD). This is
+// a bipartite matching of operations to units, so an operation is placed
+// whenever the cycle's operations fit on the units in any arrangement.
+// unitsFor[opcode] is the mask of units that can execute the opcode, as from
+// Machine::unitsFor.
+template<int Slots>
+struct CycleAssignment {
+    int unit[Slots] = {};
+    int opcode[Slots] = {};
+    unsigned busy = 0;
+    int issued[Machine::NUM_OPCODES] = {};
+
+    bool place(int id, int op, const unsigned* unitsFor, const int* limit) {
+
+        // Respect the per-cycle limit for the opcode (one OUTPUT on ILOC)
+        if (issued[op] == limit[op]) {
+            return false;
+        }
+
+        unsigned visited = 0;
+        if (!augment(id, op, unitsFor, visited)) {
+            return false;
+        }
+        issued[op]++;
+        return true;
+    }
+
+    // Put the operation on a free capable unit, or on a capable unit whose
+    // operation can move on in turn. Each unit is tried at most once.
+    bool augment(int id, int op, const unsigned* unitsFor, unsigned& visited) {
+
+        unsigned free = unitsFor[op] & ~busy;
+        if (free != 0) {
+            int u = __builtin_ctz(free);
+            unit[u] = id;
+            opcode[u] = op;
+            busy |= 1u << u;
+            return true;
+        }
+
+        for (unsigned capable = unitsFor[op]; capable != 0; capable &= capable - 1) {
+            int u = __builtin_ctz(capable);
+            if (visited & (1u << u)) {
+                continue;
+            }
+            visited |= 1u << u;
+            if (augment(unit[u], opcode[u], unitsFor, visited)) {
+                unit[u] = id;
+                opcode[u] = op;
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
 /* Schedule and Scheduler */
+
+// Priority heuristics tried by the portfolio. All of them rank operations by
+// the latency-weighted longest path first; the others break its ties by
+// dependent count, summed latency of all dependents (counted once per path),
+// pressure on the units that can execute the opcode, or a seeded random key.
+enum class Heuristic { CRITICAL_PATH, SUCCESSORS, DESCENDANT_LATENCY, UNIT_PRESSURE, RANDOM_1, RANDOM_2, RANDOM_3, NUM_HEURISTICS };
+
+const char* heuristicName(Heuristic heuristic);
+
+// Optional searches that try to improve on the greedy list schedule
+struct SchedulerOptions {
+
+    // Also schedule bottom-up and keep the shorter schedule
+    bool backward = false;
+
+    // Also list schedule with every other priority heuristic, concurrently,
+    // and keep the shortest schedule
+    bool portfolio = false;
+
+    // Schedules computed at once for -r and -H, this thread included
+    int threads = 1;
+
+    // Register limit for pressure-aware list scheduling (0 for none)
+    int registers = 0;
+
+    // Beam search lookahead, enabled by a budget of states or milliseconds
+    long beamStates = 0;
+    double beamMilliseconds = 0;
+    int beamWidth = 8;
+
+    // Exact branch and bound on small blocks, with a deadline (0 for off)
+    double optimalMilliseconds = 0;
+};
+
+// Operations issued in each cycle, one slot per unit (NOP when idle)
 struct Schedule {
-    std::vector<std::pair<Operation, Operation>> cycles;
+    int width = 0;
+    std::vector<Operation> slots;
+
+    size_t numCycles() const {
+        return width > 0 ? slots.size() / width : 0;
+    }
+
+    const Operation* cycle(size_t c) const {
+        return slots.data() + c * width;
+    }
 };
 
 class Scheduler {
 public:
+    Scheduler(Stats* stats = nullptr, const Machine& machine = Machine(), const SchedulerOptions& options = SchedulerOptions())
+        : stats(stats), machine(machine), options(options) {}
+
     Schedule schedule (InternalRepresentation& rep);
 
-private:
+    // Schedule a block that has not been renamed yet. Renaming, graph
+    // construction and priorities are fused into two passes over the block.
+    Schedule scheduleFused (InternalRepresentation& rep);
+
+    // Individual phases of schedule()
     DependenceGraph buildDependenceGraph (const InternalRepresentation& rep);
-    std::unordered_map<int, int> getPriorities(DependenceGraph& graph);
+    std::vector<int> getPriorities(const DependenceGraph& graph);
+    std::vector<int> getPriorities(const DependenceGraph& graph, Heuristic heuristic);
+    Schedule listSchedule(const DependenceGraph& graph, const std::vector<int>& priorities);
+    Schedule backwardSchedule(const DependenceGraph& graph);
+    DependenceGraph buildFused (InternalRepresentation& rep, std::vector<int>& priorities);
+
+    // Most values live at once across a cycle boundary: a value is live from
+    // the cycle its definition issues in until the cycle of its last use
+    static int peakLive(const Schedule& schedule);
+
+private:
+    Stats* stats;
+    Machine machine;
+    SchedulerOptions options;
+
+    // List scheduling for a machine of the given width, or of machine.width
+    // when Width is 0. Common widths are specialised so the unit assignment
+    // loops have constant bounds. With Pressure, live values are tracked and
+    // kept under options.registers where possible.
+    template<int Width, bool Pressure = false>
+    Schedule listScheduleFor (const DependenceGraph& graph, const std::vector<int>& priorities);
+
+    template<int Operand::*Register>
+    DependenceGraph buildGraph (const InternalRepresentation& rep, int registers);
+    Schedule finish (const DependenceGraph& graph, const std::vector<int>& priorities);
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+
+/*
+ * Phase timings and counters for one scheduler run, reported by -t. Every
+ * producer takes a nullable Stats pointer, so nothing is recorded when
+ * statistics are disabled.
+ */
+struct Stats {
+    enum Phase { SCAN_PARSE, OPTIMIZE, RENAME, GRAPH, PRIORITIES, FUSED, SCHEDULE, SEARCH, OUTPUT, NUM_PHASES };
+
+    double seconds[NUM_PHASES] = {};
+
+    long tokens = 0;
+    long operations = 0;
+    long folded = 0;
+    long removed = 0;
+    long maxSR = -1;
+    long maxVR = -1;
+    long maxLive = -1;
+    long nodes = 0;
+    long edges = 0;
+    long readyPushes = 0;
+    long deferrals = 0;
+    long greedyCycles = 0;
+    long backwardCycles = 0;
+    long cycles = 0;
+    long nopSlots = 0;
+    long peakLive = 0;
+    long searchStates = 0;
+    long optimal = 0;
+
+    // What produced the final schedule: a priority heuristic, "backward" or
+    // "beam-search" (null when only the default list schedule ran)
+    const char* heuristic = nullptr;
+
+    void print(std::ostream& out, bool json) const;
+};
+
+// Adds the lifetime of the timer to one phase of a Stats, if any
+class PhaseTimer {
+public:
+    PhaseTimer(Stats* stats, Stats::Phase phase) : stats(stats), phase(phase) {
+        if (stats != nullptr) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~PhaseTimer() {
+        if (stats != nullptr) {
+            stats->seconds[phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+private:
+    Stats* stats;
+    Stats::Phase phase;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed-size work-stealing thread pool. Submitted tasks are spread across
+ * per-worker queues; a worker runs tasks from the front of its own queue and
+ * steals from the back of the others' once its own queue is empty. The
+ * destructor waits for all submitted tasks to finish.
+ */
+class ThreadPool {
+public:
+    ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    int size() const { return workers.size(); }
+
+    // Run task(0) .. task(count - 1) on the pool and wait for all of them.
+    // Must not be called from inside a pool task.
+    template<typename F>
+    void parallelFor(int count, F&& task) {
+        std::mutex doneMutex;
+        std::condition_variable done;
+        int remaining = count;
+
+        for (int i = 0; i < count; i++) {
+            submit([&, i] {
+                task(i);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (--remaining == 0) {
+                    done.notify_all();
+                }
+            });
+        }
+
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+
+    static int defaultThreads();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable available;
+    int pending;
+    int nextQueue;
+    bool stopping;
+
+    bool tryTake(int self, std::function<void()>& task);
+    void run(int self);
+};
@@ -1,150 +1,209 @@
 #pragma once
 
 #include <Token.hpp>
-#include <unordered_set>
-#include <map>
-
-class TransitionTable{
-private: 
-    static const int NUM_STATES = 42;
-    static const int NUM_CHARS = 128; 
-    
-public:
-    int table[NUM_STATES][NUM_CHARS] = {{0}};
-    std::unordered_set<int> accepting;
-    std::map<int, Category> stateToCategory;
+#include <cstdint>
+
+/*
+ * Scanner DFA, generated at compile time.
+ *
+ * Input bytes are first mapped to character equivalence classes (bytes that
+ * behave identically in every state share a class), so each state's row is
+ * only MAX_CLASSES bytes wide. States are 8-bit with -1 as the error state,
+ * and acceptance is folded into a per-state category (CAT_INVAL for
+ * non-accepting states).
+ */
+struct TransitionTable {
+    static constexpr int NUM_STATES = 42;
+    static constexpr int NUM_CHARS = 256;
+    static constexpr int MAX_CLASSES = 32;
+
+    uint8_t charClass[NUM_CHARS] = {};
+    int8_t table[NUM_STATES][MAX_CLASSES] = {};
+    Category category[NUM_STATES] = {};
+    int numClasses = 0;
+
+    constexpr int next(int state, unsigned char c) const {
+        return table[state][charClass[c]];
+    }
+
+    constexpr bool isAccepting(int state) const {
+        return category[state] != Category::CAT_INVAL;
+    }
+};
 
-    TransitionTable() {
+class TransitionTableBuilder {
+public:
+    constexpr TransitionTableBuilder() : table(), category() {
 
         for (int i = 0; i < NUM_STATES; i++) {
             for (int j = 0; j < NUM_CHARS; j++) {
                 table[i][j] = -1;
             }
+            category[i] = Category::CAT_INVAL;
         }
 
         // STORE
-        table[0]['s'] = 1;
-        table[1]['t'] = 2;
-        table[2]['o'] = 3;
-        table[3]['r'] = 4;
-        table[4]['e'] = 5;
-        
-        accepting.insert(5);
-        stateToCategory[5] = Category::CAT_MEMOP;
+        set(0, 's', 1);
+        set(1, 't', 2);
+        set(2, 'o', 3);
+        set(3, 'r', 4);
+        set(4, 'e', 5);
+
+        category[5] = Category::CAT_MEMOP;
 
         // SUB
-        table[1]['u'] = 6;
-        table[6]['b'] = 7;
-        
-        accepting.insert(7);
-        stateToCategory[7] = Category::CAT_ARITHOP;
+        set(1, 'u', 6);
+        set(6, 'b', 7);
+
+        category[7] = Category::CAT_ARITHOP;
 
         // LOAD + LOADI
-        table[0]['l'] = 8;
-        table[8]['o'] = 9;
-        table[9]['a'] = 10;
-        table[10]['d'] = 11;
-        table[11]['I'] = 12;
-        
-        accepting.insert(11);
-        stateToCategory[11] = Category::CAT_MEMOP;
-        
-        accepting.insert(12);
-        stateToCategory[12] = Category::CAT_LOADI;
+        set(0, 'l', 8);
+        set(8, 'o', 9);
+        set(9, 'a', 10);
+        set(10, 'd', 11);
+        set(11, 'I', 12);
+
+        category[11] = Category::CAT_MEMOP;
+        category[12] = Category::CAT_LOADI;
 
         // RSHIFT + LSHIFT
-        table[0]['r'] = 13;
-        table[13]['s'] = 14;
-        table[8]['s'] = 14;
-        table[14]['h'] = 15;
-        table[15]['i'] = 16;
-        table[16]['f'] = 17;
-        table[17]['t'] = 18;
+        set(0, 'r', 13);
+        set(13, 's', 14);
+        set(8, 's', 14);
+        set(14, 'h', 15);
+        set(15, 'i', 16);
+        set(16, 'f', 17);
+        set(17, 't', 18);
 
-        accepting.insert(18);
-        stateToCategory[18] = Category::CAT_ARITHOP;
+        category[18] = Category::CAT_ARITHOP;
 
         // MULT
-        table[0]['m'] = 19;
-        table[19]['u'] = 20;
-        table[20]['l'] = 21;
-        table[21]['t'] = 18;
+        set(0, 'm', 19);
+        set(19, 'u', 20);
+        set(20, 'l', 21);
+        set(21, 't', 18);
 
         // ADD
-        table[0]['a'] = 22;
-        table[22]['d'] = 23;
-        table[23]['d'] = 24;
+        set(0, 'a', 22);
+        set(22, 'd', 23);
+        set(23, 'd', 24);
 
-        accepting.insert(24);
-        stateToCategory[24] = Category::CAT_ARITHOP;
+        category[24] = Category::CAT_ARITHOP;
 
         // NOP
-        table[0]['n'] = 25;
-        table[25]['o'] = 26;
-        table[26]['p'] = 27;
+        set(0, 'n', 25);
+        set(25, 'o', 26);
+        set(26, 'p', 27);
 
-        accepting.insert(27);
-        stateToCategory[27] = Category::CAT_NOP;
+        category[27] = Category::CAT_NOP;
 
         // OUTPUT
-        table[0]['o'] = 28;
-        table[28]['u'] = 29;
-        table[29]['t'] = 30;
-        table[30]['p'] = 31;
-        table[31]['u'] = 32;
-        table[32]['t'] = 33;
+        set(0, 'o', 28);
+        set(28, 'u', 29);
+        set(29, 't', 30);
+        set(30, 'p', 31);
+        set(31, 'u', 32);
+        set(32, 't', 33);
 
-        accepting.insert(33);
-        stateToCategory[33] = Category::CAT_OUTPUT;
+        category[33] = Category::CAT_OUTPUT;
 
         // INTO
-        table[0]['='] = 34;
-        table[34]['>'] = 35;
+        set(0, '=', 34);
+        set(34, '>', 35);
 
-        accepting.insert(35);
-        stateToCategory[35] = Category::CAT_INTO;
+        category[35] = Category::CAT_INTO;
 
         // COMMA
-        table[0][','] = 36;
+        set(0, ',', 36);
 
-        accepting.insert(36);
-        stateToCategory[36] = Category::CAT_COMMA;
+        category[36] = Category::CAT_COMMA;
 
         // EOL
-        table[0]['\n'] = 37;
+        set(0, '\n', 37);
 
-        accepting.insert(37);
-        stateToCategory[37] = Category::CAT_EOL;
+        category[37] = Category::CAT_EOL;
 
-        // CONSTANT ('0' = 48 -> '9' = 57)
-        for (int i = 48; i <= 57; i++) {
-            table[0][i] = 38;
-            table[38][i] = 38;
+        // CONSTANT
+        for (char c = '0'; c <= '9'; c++) {
+            set(0, c, 38);
+            set(38, c, 38);
         }
 
-        accepting.insert(38);
-        stateToCategory[38] = Category::CAT_CONSTANT;
+        category[38] = Category::CAT_CONSTANT;
 
         // REGISTER
-        for (int i = 48; i <= 57; i++) {
-            table[13][i] = 39;
-            table[39][i] = 39;
+        for (char c = '0'; c <= '9'; c++) {
+            set(13, c, 39);
+            set(39, c, 39);
         }
 
-        accepting.insert(39);
-        stateToCategory[39] = Category::CAT_REGISTER;
+        category[39] = Category::CAT_REGISTER;
 
         // COMMENT
-        table[0]['/'] = 40;
-        table[40]['/'] = 41;
+        set(0, '/', 40);
+        set(40, '/', 41);
         for (int i = 0; i < NUM_CHARS; i++) {
             table[41][i] = 41;
         }
-        table[41]['\n'] = 37;
+        set(41, '\n', 37);
 
         // WHITESPACE
-        table[0][' '] = 0;
-        table[0]['\t'] = 0;
-        table[0]['\r'] = 0;
+        set(0, ' ', 0);
+        set(0, '\t', 0);
+        set(0, '\r', 0);
     }
-};
\ No newline at end of file
+
+    // Merge identical columns into character classes and emit the compact table
+    constexpr TransitionTable compress() const {
+        TransitionTable result;
+        int representative[TransitionTable::MAX_CLASSES] = {};
+
+        for (int c = 0; c < NUM_CHARS; c++) {
+            int found = -1;
+            for (int k = 0; k < result.numClasses && found == -1; k++) {
+                if (sameColumn(c, representative[k])) {
+                    found = k;
+                }
+            }
+            if (found == -1) {
+                found = result.numClasses++;
+                representative[found] = c;
+            }
+            result.charClass[c] = found;
+        }
+
+        for (int i = 0; i < NUM_STATES; i++) {
+            for (int k = 0; k < result.numClasses; k++) {
+                result.table[i][k] = table[i][representative[k]];
+            }
+            result.category[i] = category[i];
+        }
+
+        return result;
+    }
+
+private:
+    static constexpr int NUM_STATES = TransitionTable::NUM_STATES;
+    static constexpr int NUM_CHARS = TransitionTable::NUM_CHARS;
+
+    int8_t table[NUM_STATES][NUM_CHARS];
+    Category category[NUM_STATES];
+
+    constexpr void set(int from, char c, int to) {
+        table[from][(unsigned char) c] = to;
+    }
+
+    constexpr bool sameColumn(int a, int b) const {
+        for (int i = 0; i < NUM_STATES; i++) {
+            if (table[i][a] != table[i][b]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+inline constexpr TransitionTable TRANSITION_TABLE = TransitionTableBuilder().compress();
+
+static_assert(TRANSITION_TABLE.numClasses <= TransitionTable::MAX_CLASSES, "Too many character classes for the scanner DFA.");
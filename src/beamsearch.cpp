@@ -0,0 +1,118 @@
+#include <BeamSearch.hpp>
+#include <algorithm>
+#include <climits>
+
+BeamSearch::BeamSearch(const DependenceGraph& graph, const std::vector<int>& priorities, const Machine& machine,
+                       long maxStates, double maxMilliseconds, int beamWidth)
+    : ScheduleSearch(graph, priorities, machine), maxStates(maxStates > 0 ? maxStates : LONG_MAX),
+      maxMilliseconds(maxMilliseconds), beamWidth(std::max(beamWidth, 1)), states(0) {}
+
+bool BeamSearch::exhausted() const {
+    if (states >= maxStates) {
+        return true;
+    }
+    if (maxMilliseconds > 0) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() >= maxMilliseconds;
+    }
+    return false;
+}
+
+bool BeamSearch::improve(int cycles, Schedule& result) {
+
+    int n = graph.numNodes();
+    if (n == 0 || n > MAX_NODES) {
+        return false;
+    }
+    start = std::chrono::steady_clock::now();
+
+    State initial {SearchState::initial(graph)};
+    computeBound(initial);
+
+    int best = cycles;
+    State bestState;
+    bool found = false;
+
+    std::vector<State> beam;
+    beam.push_back(std::move(initial));
+    std::vector<State> children;
+
+    while (!beam.empty() && !exhausted()) {
+
+        children.clear();
+        for (State& state : beam) {
+            expand(state, children);
+        }
+
+        // Record complete schedules and prune children that cannot win
+        std::vector<State> kept;
+        for (State& child : children) {
+            if (child.scheduled == n) {
+                int length = std::max(child.cycle - 1, child.finish);
+                if (length < best) {
+                    best = length;
+                    bestState = std::move(child);
+                    found = true;
+                }
+            } else if (child.bound < best) {
+                kept.push_back(std::move(child));
+            }
+        }
+
+        // Keep the most promising children
+        std::stable_sort(kept.begin(), kept.end(), [] (const State& a, const State& b) {
+            if (a.bound != b.bound) {
+                return a.bound < b.bound;
+            }
+            return a.scheduled > b.scheduled;
+        });
+        if ((int) kept.size() > beamWidth) {
+            kept.erase(kept.begin() + beamWidth, kept.end());
+        }
+        beam = std::move(kept);
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    materialise(bestState.slots, best, result);
+    return true;
+}
+
+void BeamSearch::expand(State& state, std::vector<State>& children) {
+
+    skipIdle(state, state.slots);
+
+    // The greedy assignment first, then up to BRANCHING - 1 other maximal
+    // assignments of the leading candidates, preferring higher total priority
+    std::vector<int> ready = candidates(state);
+    int branching = std::min<int>(ready.size(), std::min(2 * machine.width, 8));
+    std::vector<Assignment> options;
+    assignments(ready, branching, MAX_LEAVES, options);
+    if ((int) options.size() > BRANCHING) {
+        options.resize(BRANCHING);
+    }
+
+    for (const Assignment& units : options) {
+        State child = state;
+        issueCycle(child, units, priorities, child.slots);
+        computeBound(child);
+        children.push_back(std::move(child));
+        states++;
+    }
+}
+
+// Lower bound on the final length: dependence paths from issued and ready
+// operations, and the issue slots needed by everything left
+void BeamSearch::computeBound(State& state) {
+
+    int bound = std::max(state.finish, state.pathBound);
+    for (int id : state.ready) {
+        bound = std::max(bound, std::max(state.earliest[id], state.cycle) + priorities[id]);
+    }
+    int remaining = graph.numNodes() - state.scheduled;
+    int width = machine.width;
+    bound = std::max(bound, state.cycle - 1 + (remaining + width - 1) / width);
+    state.bound = bound;
+}
@@ -0,0 +1,150 @@
+#include <BranchAndBound.hpp>
+#include <algorithm>
+
+BranchAndBound::BranchAndBound(const DependenceGraph& graph, const std::vector<int>& priorities, const Machine& machine,
+                               double maxMilliseconds)
+    : ScheduleSearch(graph, priorities, machine), maxMilliseconds(maxMilliseconds), states(0), complete(false),
+      best(0), floor(0), bound(graph, machine), tail(bound.tails()) {}
+
+bool BranchAndBound::exhausted() const {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() >= maxMilliseconds;
+}
+
+bool BranchAndBound::improve(int cycles, Schedule& result) {
+
+    int n = graph.numNodes();
+    complete = false;
+    if (n == 0 || n > MAX_NODES) {
+        return false;
+    }
+    start = std::chrono::steady_clock::now();
+
+    State initial = SearchState::initial(graph);
+
+    best = cycles;
+    path.clear();
+    bestPath.clear();
+    visited.clear();
+    complete = true;
+    floor = bound.compute(initial);
+    if (floor < best) {
+        search(initial);
+    }
+
+    // A schedule as short as the initial lower bound is optimal, whatever
+    // was left unexplored
+    if (best <= floor) {
+        complete = true;
+    }
+
+    if (bestPath.empty()) {
+        return false;
+    }
+
+    materialise(bestPath, best, result);
+    return true;
+}
+
+void BranchAndBound::search(State& state) {
+
+    if (exhausted()) {
+        complete = false;
+        return;
+    }
+    states++;
+
+    size_t depth = path.size();
+
+    // A complete schedule
+    if (state.scheduled == graph.numNodes()) {
+        int length = std::max(state.cycle - 1, state.finish);
+        if (length < best) {
+            best = length;
+            bestPath = path;
+        }
+        return;
+    }
+
+    skipIdle(state, path);
+
+    if (seen(state)) {
+        path.resize(depth);
+        return;
+    }
+
+    // Every maximal assignment of the candidates
+    std::vector<int> ready = candidates(state);
+    std::vector<Assignment> options;
+    if (!assignments(ready, ready.size(), MAX_CHILDREN, options)) {
+        complete = false;
+    }
+
+    for (const Assignment& units : options) {
+
+        // A candidate left for a later cycle must still fit its tail
+        bool late = false;
+        for (int id : ready) {
+            late = late || (!assigned(units, id) && state.cycle + 1 + tail[id] >= best);
+        }
+        if (late) {
+            continue;
+        }
+
+        State child = state;
+        size_t row = path.size();
+        issueCycle(child, units, tail, path);
+
+        if (bound.compute(child) < best) {
+            search(child);
+        }
+        path.resize(row);
+
+        if (best <= floor || (!complete && exhausted())) {
+            break;
+        }
+    }
+
+    path.resize(depth);
+}
+
+// Whether the same operations were issued with the same operations in flight
+// (relative to the cycle) at this or an earlier cycle. Records the state
+// otherwise, while the table has room.
+bool BranchAndBound::seen(const State& state) {
+
+    std::string key;
+    int n = graph.numNodes();
+    key.reserve(n / 8 + 16);
+    unsigned char bits = 0;
+    for (int id = 1; id <= n; id++) {
+        bits = bits << 1 | (state.pending[id] == -1);
+        if (id % 8 == 0 || id == n) {
+            key.push_back(bits);
+            bits = 0;
+        }
+    }
+    auto append = [&] (int value) {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    append(std::max(state.finish - state.cycle, 0));
+    for (int id = 1; id <= n; id++) {
+        if (state.pending[id] != -1 && state.earliest[id] > state.cycle) {
+            append(id);
+            append(state.earliest[id] - state.cycle);
+        }
+    }
+
+    auto found = visited.find(key);
+    if (found != visited.end()) {
+        if (found->second <= state.cycle) {
+            return true;
+        }
+        found->second = state.cycle;
+        return false;
+    }
+    if (visited.size() < MAX_VISITED) {
+        visited.emplace(std::move(key), state.cycle);
+    }
+    return false;
+}
@@ -0,0 +1,116 @@
+#include <ChunkedParser.hpp>
+#include <Scanner.hpp>
+#include <Parser.hpp>
+#include <RegisterMap.hpp>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+InternalRepresentation ChunkedParser::parse() {
+
+    const char* data = input.data();
+    size_t size = input.size();
+
+    // Split the input into chunks that each end just after a newline
+    size_t target = std::max(MIN_CHUNK_SIZE, size / (4 * pool.size()) + 1);
+    std::vector<size_t> bounds = {0};
+    while (bounds.back() < size) {
+        size_t end = std::min(bounds.back() + target, size) - 1;
+        const void* eol = std::memchr(data + end, '\n', size - end);
+        bounds.push_back(static_cast<const char*>(eol) - data + 1);
+    }
+    int chunks = bounds.size() - 1;
+
+    // Number the first line of each chunk
+    std::vector<int> firstLine (chunks + 1, 1);
+    pool.parallelFor(chunks, [&] (int i) {
+        firstLine[i + 1] = std::count(data + bounds[i], data + bounds[i + 1], '\n');
+    });
+    for (int i = 0; i < chunks; i++) {
+        firstLine[i + 1] += firstLine[i];
+    }
+
+    // Scan and parse every chunk independently
+    struct Chunk {
+        std::unique_ptr<Diagnostics> diagnostics;
+        InternalRepresentation rep;
+        int errors = 0;
+        long tokens = 0;
+    };
+    std::vector<Chunk> results (chunks);
+
+    pool.parallelFor(chunks, [&] (int i) {
+        Chunk& chunk = results[i];
+        chunk.diagnostics = std::make_unique<Diagnostics>(maxErrors);
+        Scanner scanner (data + bounds[i], bounds[i + 1] - bounds[i], firstLine[i], *chunk.diagnostics);
+        Parser parser (scanner, *chunk.diagnostics, firstLine[i]);
+        try {
+            chunk.rep = parser.parse();
+        } catch (ParseFailedException& e) {
+            chunk.errors = parser.errorCount();
+        }
+        chunk.tokens = scanner.tokenCount();
+    });
+
+    // Merge diagnostics and register names in input order. Registers keep
+    // their order of first appearance, so dense indices match a serial parse.
+    int errors = 0;
+    RegisterMap registers;
+    std::vector<std::vector<int>> remap (chunks);
+    std::vector<size_t> offset (chunks + 1, 0);
+    for (int i = 0; i < chunks; i++) {
+        diagnostics.merge(*results[i].diagnostics);
+        errors += results[i].errors;
+        tokens += results[i].tokens;
+        for (int name : results[i].rep.registerNames) {
+            remap[i].push_back(registers.index(name));
+        }
+        offset[i + 1] = offset[i] + results[i].rep.operations.size();
+    }
+
+    if (errors > 0) {
+        throw ParseFailedException("Parse failed with " + std::to_string(errors) + " errors.");
+    }
+
+    // Concatenate operations, rewriting chunk-local register indices
+    InternalRepresentation rep;
+    rep.operations.resize(offset[chunks]);
+    pool.parallelFor(chunks, [&] (int i) {
+        auto translate = [&] (Operand& o) {
+            if (o.SR != -1) {
+                o.SR = remap[i][o.SR];
+            }
+        };
+        Operation* out = rep.operations.data() + offset[i];
+        for (Operation op : results[i].rep.operations) {
+            switch (op.opcode) {
+                case Opcode::LOAD:
+                case Opcode::STORE:
+                    translate(op.op1);
+                    translate(op.op3);
+                    break;
+                case Opcode::LOADI:
+                    translate(op.op3);
+                    break;
+                case Opcode::ADD:
+                case Opcode::SUB:
+                case Opcode::MULT:
+                case Opcode::LSHIFT:
+                case Opcode::RSHIFT:
+                    translate(op.op1);
+                    translate(op.op2);
+                    translate(op.op3);
+                    break;
+                default:
+                    break;
+            }
+            *out++ = op;
+        }
+        results[i].rep.operations = std::vector<Operation>();
+    });
+
+    rep.maxSR = registers.size() - 1;
+    rep.registerNames = registers.names();
+    return rep;
+}
@@ -0,0 +1,56 @@
+#include <Diagnostics.hpp>
+#include <charconv>
+
+bool Diagnostics::begin(int line) {
+    if (full()) {
+        return false;
+    }
+    errors++;
+
+    char digits[16];
+    auto [end, error] = std::to_chars(digits, digits + sizeof(digits), line);
+    buffer += "ERROR ";
+    buffer.append(digits, end - digits);
+    buffer += ": ";
+    return true;
+}
+
+void Diagnostics::error(int line, std::string_view message) {
+    if (!begin(line)) {
+        return;
+    }
+    buffer += message;
+    buffer += '\n';
+}
+
+void Diagnostics::error(int line, std::string_view word, std::string_view message) {
+    if (!begin(line)) {
+        return;
+    }
+    buffer += '"';
+    buffer += word;
+    buffer += "\" ";
+    buffer += message;
+    buffer += '\n';
+}
+
+void Diagnostics::merge(const Diagnostics& other) {
+    size_t start = 0;
+    while (start < other.buffer.size() && !full()) {
+        size_t end = other.buffer.find('\n', start) + 1;
+        buffer.append(other.buffer, start, end - start);
+        errors++;
+        start = end;
+    }
+}
+
+void Diagnostics::flush(std::ostream& out) {
+    if (full() && !buffer.empty()) {
+        buffer += "Too many errors, stopped after ";
+        buffer += std::to_string(errors);
+        buffer += ".\n";
+    }
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+    buffer.clear();
+}
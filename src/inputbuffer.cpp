@@ -0,0 +1,67 @@
+#include <InputBuffer.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+InputBuffer::InputBuffer(const std::string& filename) : mapped(nullptr), mappedLength(0), begin(nullptr), length(0) {
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw FileNotFoundException("Failed to open file: " + filename);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+
+        // Map regular files directly
+        void* addr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            const char* bytes = static_cast<const char*>(addr);
+
+            // The scanner relies on a trailing newline, so only keep the
+            // mapping if the file already ends with one
+            if (bytes[info.st_size - 1] == '\n') {
+                madvise(addr, info.st_size, MADV_SEQUENTIAL);
+                mapped = addr;
+                mappedLength = info.st_size;
+                begin = bytes;
+                length = info.st_size;
+                close(fd);
+                return;
+            }
+            munmap(addr, info.st_size);
+        }
+    }
+
+    // Fall back to a buffered read for pipes and unterminated files
+    readStream(fd);
+    close(fd);
+}
+
+InputBuffer::~InputBuffer() {
+    if (mapped != nullptr) {
+        munmap(mapped, mappedLength);
+    }
+}
+
+void InputBuffer::readStream(int fd) {
+    const size_t CHUNK = 1 << 16;
+    size_t used = 0;
+
+    while (true) {
+        buffer.resize(used + CHUNK);
+        ssize_t n = read(fd, &buffer[used], CHUNK);
+        if (n <= 0) {
+            break;
+        }
+        used += n;
+    }
+    buffer.resize(used);
+
+    if (!buffer.empty() && buffer.back() != '\n') {
+        buffer += '\n';
+    }
+    begin = buffer.data();
+    length = buffer.size();
+}
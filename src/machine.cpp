@@ -0,0 +1,131 @@
+#include <Machine.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// Opcode named by a word of a machine description, or -1
+static int findOpcode(const std::string& word) {
+    for (int i = 0; i < Machine::NUM_OPCODES; i++) {
+        if (OpcodeNames[i] == word) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+Machine Machine::load(const std::string& filename) {
+
+    std::ifstream file (filename);
+    if (!file.is_open()) {
+        throw MachineDescriptionException("Could not open machine description " + filename + ".");
+    }
+
+    Machine machine;
+    bool listed[MAX_WIDTH] = {};
+    std::string text;
+    int line = 0;
+
+    auto fail = [&] (const std::string& message) {
+        throw MachineDescriptionException(filename + ":" + std::to_string(line) + ": " + message);
+    };
+
+    // Read an integer operand in [low, high]
+    auto number = [&] (std::istringstream& in, const char* what, int low, int high) {
+        long value;
+        if (!(in >> value) || value < low || value > high) {
+            fail(std::string("Expected ") + what + " between " + std::to_string(low) + " and " + std::to_string(high) + ".");
+        }
+        return (int) value;
+    };
+
+    auto opcode = [&] (std::istringstream& in) {
+        std::string word;
+        in >> word;
+        int op = findOpcode(word);
+        if (op == -1) {
+            fail("\"" + word + "\" is not an opcode.");
+        }
+        return op;
+    };
+
+    while (std::getline(file, text)) {
+        line++;
+        text = text.substr(0, std::min(text.find("//"), text.find('#')));
+
+        std::istringstream in (text);
+        std::string directive;
+        if (!(in >> directive)) {
+            continue;
+        }
+
+        if (directive == "width") {
+            machine.width = number(in, "a width", 1, MAX_WIDTH);
+        } else if (directive == "unit") {
+            int unit = number(in, "a unit", 0, MAX_WIDTH - 1);
+            // Every unit can idle, whether or not it lists nop
+            machine.units[unit] = mask(Opcode::NOP);
+            listed[unit] = true;
+            std::string word;
+            while (in >> word) {
+                std::istringstream single (word);
+                machine.units[unit] |= 1 << opcode(single);
+            }
+        } else if (directive == "latency") {
+            int op = opcode(in);
+            machine.latency[op] = number(in, "a latency", 1, MAX_LATENCY);
+        } else if (directive == "limit") {
+            int op = opcode(in);
+            machine.limit[op] = number(in, "a limit", 1, MAX_WIDTH);
+        } else {
+            fail("Unknown directive \"" + directive + "\".");
+        }
+
+        std::string extra;
+        if (in >> extra) {
+            fail("Extra text \"" + extra + "\".");
+        }
+    }
+
+    for (int u = machine.width; u < MAX_WIDTH; u++) {
+        if (listed[u]) {
+            throw MachineDescriptionException(filename + ": Unit " + std::to_string(u) + " is beyond the machine width.");
+        }
+    }
+
+    // Every opcode must be executable somewhere, or it could never be scheduled
+    for (int i = 0; i < NUM_OPCODES; i++) {
+        if (machine.unitsFor((Opcode) i) == 0) {
+            throw MachineDescriptionException(filename + ": No unit can execute " + OpcodeNames[i] + ".");
+        }
+    }
+
+    return machine;
+}
+
+std::vector<Machine::Resource> Machine::resources() const {
+
+    std::vector<Resource> result;
+    for (unsigned set = 1; set < (1u << width); set++) {
+        OpcodeMask opcodes = 0;
+        unsigned covered = 0;
+        for (int i = 0; i < NUM_OPCODES; i++) {
+            unsigned capable = unitsFor((Opcode) i);
+            if (capable != 0 && (capable & ~set) == 0) {
+                opcodes |= mask((Opcode) i);
+                covered |= capable;
+            }
+        }
+        if (opcodes != 0 && covered == set) {
+            result.push_back({opcodes, set, __builtin_popcount(set)});
+        }
+    }
+
+    for (int i = 0; i < NUM_OPCODES; i++) {
+        unsigned capable = unitsFor((Opcode) i);
+        if (limit[i] < __builtin_popcount(capable)) {
+            result.push_back({mask((Opcode) i), capable, limit[i]});
+        }
+    }
+
+    return result;
+}
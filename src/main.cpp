@@ -1,49 +1,225 @@
 #include <Scanner.hpp>
 #include <Parser.hpp>
 #include <Renamer.hpp>
+#include <Optimizer.hpp>
 #include <Scheduler.hpp>
+#include <Machine.hpp>
+#include <ChunkedParser.hpp>
+#include <Diagnostics.hpp>
+#include <ThreadPool.hpp>
+#include <Stats.hpp>
+#include <OutputWriter.hpp>
+#include <ScheduleReport.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
 #include <iostream>
+#include <sstream>
 #include <cstring>
+#include <cstdlib>
 
 void help () {
-   std::cout << "Command Syntax: schedule [-h] [<name>]" << std::endl;
+   std::cout << "Command Syntax: schedule [-h] [-e <errors>] [-t | --stats[=json]] [--report] [-m <machine>] [-c] [-r] [-H] [-k <registers>] [-l <states>] [-T <ms>] [-o <ms>] [-p] [-f] [-b] [-j <threads>] [<name> ...]" << std::endl;
    std::cout << "Options:" << std::endl;
    std::cout << "   -h: Print this help menu." << std::endl;
+   std::cout << "   -e <errors>: Stop reporting syntax errors after <errors> errors (default: no limit)." << std::endl;
+   std::cout << "   -t, --stats: Print phase times and counters to stderr. --stats=json prints them as JSON." << std::endl;
+   std::cout << "   --report: Print a JSON quality report of each schedule to stderr: lower bounds on its length, the gap to the best bound, NOP slots and unit utilization." << std::endl;
+   std::cout << "   -b: Batch mode. Schedule every input in parallel; each <name> may be a file, a directory, or @<manifest> listing one file per line. -p is ignored and -r and -H run on each input's worker thread." << std::endl;
+   std::cout << "   -m <machine>: Schedule for the machine described in <machine> (default: the two-unit ILOC target)." << std::endl;
+   std::cout << "   -c: Clean up the block before scheduling: fold arithmetic on constants into loadI and remove operations whose result is never used (-t reports how many)." << std::endl;
+   std::cout << "   -r: Also list schedule bottom-up (in reverse), on a second thread when -j allows, and keep the shorter schedule." << std::endl;
+   std::cout << "   -H: Also list schedule with a portfolio of priority heuristics, concurrently, and keep the shortest schedule (-t reports the winner)." << std::endl;
+   std::cout << "   -k <registers>: Track live values while scheduling and, near <registers> live values, prefer operations that end live ranges." << std::endl;
+   std::cout << "   -l <states>: Lookahead. Search for a shorter schedule by beam search, exploring at most <states> states." << std::endl;
+   std::cout << "   -T <ms>: Time budget in milliseconds for the schedule search (enables -l without a state limit)." << std::endl;
+   std::cout << "   -o <ms>: Search blocks of up to 1024 operations for a shortest schedule by branch and bound, for at most <ms> milliseconds." << std::endl;
+   std::cout << "   -p: Parse and rename a single large input in parallel." << std::endl;
+   std::cout << "   -f: Fused front end. Rename, build the dependence graph and compute priorities in two passes over the block." << std::endl;
+   std::cout << "   -j <threads>: Number of worker threads for -b, -p, -r and -H (default: one per core)." << std::endl;
    std::cout << "   <name>: Invoke schedule on the input ILOC block contained in <name> and output a reordered or scheduled ILOC block." << std::endl;
 }
 
-void schedule (std::string filename) {
+enum class StatsMode {
+   NONE,
+   TEXT,
+   JSON
+};
 
-   try {
-      Scanner scanner (filename);
+struct Options {
+   int maxErrors = Diagnostics::UNLIMITED;
+   int threads = ThreadPool::defaultThreads();
+   bool batch = false;
+   bool parallel = false;
+   bool fused = false;
+   bool cleanup = false;
+   StatsMode stats = StatsMode::NONE;
+   bool report = false;
+   Machine machine;
+   SchedulerOptions scheduling;
+};
+
+// Scan and parse an input, either sequentially or in chunks on a thread pool
+InternalRepresentation parse (std::string filename, const Options& options, ThreadPool* pool, Diagnostics& diagnostics, long& tokens) {
+
+   if (pool != nullptr) {
+      InputBuffer input (filename);
+      ChunkedParser parser (input, diagnostics, *pool, options.maxErrors);
+      InternalRepresentation rep = parser.parse();
+      tokens = parser.tokenCount();
+      return rep;
+   }
+
+   Scanner scanner (filename, diagnostics);
+   Parser parser (scanner, diagnostics);
+   InternalRepresentation rep = parser.parse();
+   tokens = scanner.tokenCount();
+   return rep;
+}
+
+void schedule (std::string filename, const Options& options, std::ostream& out, std::ostream& err) {
 
+   Diagnostics diagnostics (options.maxErrors);
+   Stats collected;
+   Stats* stats = options.stats != StatsMode::NONE ? &collected : nullptr;
+   std::unique_ptr<ThreadPool> pool = options.parallel ? std::make_unique<ThreadPool>(options.threads) : nullptr;
+
+   try {
       try {
 
-         Parser parser (scanner);
-         InternalRepresentation rep = parser.parse();
+         InternalRepresentation rep;
+         long tokens = 0;
+         {
+            PhaseTimer timer (stats, Stats::SCAN_PARSE);
+            rep = parse(filename, options, pool.get(), diagnostics, tokens);
+         }
+         diagnostics.flush(err);
 
          try {
 
-            Renamer renamer;
-            renamer.rename(rep);
+            if (options.cleanup) {
+               PhaseTimer timer (stats, Stats::OPTIMIZE);
+               Optimizer(stats).optimize(rep);
+            }
 
-            Scheduler scheduler;
-            Schedule schedule = scheduler.schedule(rep);
+            Scheduler scheduler (stats, options.machine, options.scheduling);
+            Schedule schedule;
+            if (options.fused) {
+               schedule = scheduler.scheduleFused(rep);
+            } else {
+               Renamer renamer (pool.get());
+               {
+                  PhaseTimer timer (stats, Stats::RENAME);
+                  renamer.rename(rep);
+               }
+               schedule = scheduler.schedule(rep);
+            }
 
             // Print output
-            for (const auto& cycle : schedule.cycles) {
-               std::cout << "[ " << cycle.first.printVR() << " ; " << cycle.second.printVR() << " ]" << std::endl;
+            {
+               PhaseTimer timer (stats, Stats::OUTPUT);
+               OutputWriter writer (out);
+               for (size_t c = 0; c < schedule.numCycles(); c++) {
+                  writer.writeCycle(schedule.cycle(c), schedule.width);
+               }
+            }
+
+            // Lower bounds and gap, against a graph of the renamed block
+            if (options.report) {
+               ScheduleReport::analyze(scheduler.buildDependenceGraph(rep), schedule, options.machine).print(err, filename);
+            }
+
+            if (stats != nullptr) {
+               stats->tokens = tokens;
+               stats->operations = rep.operations.size();
+               stats->maxSR = rep.maxSR;
+               stats->maxVR = rep.maxVR;
+               stats->maxLive = rep.maxLive;
+               stats->print(err, options.stats == StatsMode::JSON);
             }
             
          } catch (RenamingFailedException& e) {
-            std::cerr << "ERROR: " << e.what() << std::endl;
+            err << "ERROR: " << e.what() << std::endl;
          }
       } catch (ParseFailedException& e) {
-         std::cerr << "Due to syntax errors, run terminates." << std::endl;
+         diagnostics.flush(err);
+         err << "Due to syntax errors, run terminates." << std::endl;
       }
    } catch (FileNotFoundException& e) {
-      std::cerr << "ERROR: " << e.what() << std::endl;
+      err << "ERROR: " << e.what() << std::endl;
+   }
+}
+
+// Expand batch arguments (files, directories and @manifests) into file names
+std::vector<std::string> collectInputs (char* names[], int count) {
+
+   std::vector<std::string> inputs;
+
+   for (int i = 0; i < count; i++) {
+      std::string name = names[i];
+
+      if (name.size() > 1 && name[0] == '@') {
+         std::ifstream manifest (name.substr(1));
+         if (!manifest.is_open()) {
+            inputs.push_back(name.substr(1));
+            continue;
+         }
+         std::string line;
+         while (std::getline(manifest, line)) {
+            if (!line.empty()) {
+               inputs.push_back(line);
+            }
+         }
+      } else if (std::filesystem::is_directory(name)) {
+         std::vector<std::string> files;
+         for (const auto& entry : std::filesystem::directory_iterator(name)) {
+            if (entry.is_regular_file()) {
+               files.push_back(entry.path().string());
+            }
+         }
+         std::sort(files.begin(), files.end());
+         inputs.insert(inputs.end(), files.begin(), files.end());
+      } else {
+         inputs.push_back(name);
+      }
+   }
+
+   return inputs;
+}
+
+// Schedule many inputs on a thread pool. Each block's output and errors are
+// buffered and written in input order, headed by an ILOC comment naming it.
+void scheduleBatch (const std::vector<std::string>& inputs, const Options& options) {
+
+   struct Result {
+      std::string out;
+      std::string err;
+   };
+
+   std::vector<std::future<Result>> results;
+   results.reserve(inputs.size());
+
+   ThreadPool pool (options.threads);
+   for (const std::string& filename : inputs) {
+      auto task = std::make_shared<std::packaged_task<Result()>>([filename, &options] {
+         std::ostringstream out, err;
+         schedule(filename, options, out, err);
+         return Result {out.str(), err.str()};
+      });
+      results.push_back(task->get_future());
+      pool.submit([task] { (*task)(); });
+   }
+
+   for (size_t i = 0; i < inputs.size(); i++) {
+      Result result = results[i].get();
+      std::cout << "// " << inputs[i] << "\n" << result.out;
+      if (!result.err.empty()) {
+         std::cerr << "// " << inputs[i] << "\n" << result.err;
+      }
    }
+   std::cout.flush();
 }
 
 int main (int argc, char *argv[]) {
@@ -53,10 +229,77 @@ int main (int argc, char *argv[]) {
       return -1;
    }
 
-   if (!strcmp(argv[1], "-h")){
-      help();
+   Options options;
+   int arg = 1;
+
+   for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+      if (!strcmp(argv[arg], "-h")) {
+         help();
+         return 0;
+      } else if (!strcmp(argv[arg], "-b")) {
+         options.batch = true;
+      } else if (!strcmp(argv[arg], "-p")) {
+         options.parallel = true;
+      } else if (!strcmp(argv[arg], "-m")) {
+         if (arg + 1 >= argc) {
+            std::cerr << "ERROR: -m requires a machine description." << std::endl;
+            return -1;
+         }
+         try {
+            options.machine = Machine::load(argv[++arg]);
+         } catch (MachineDescriptionException& e) {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+            return -1;
+         }
+      } else if (!strcmp(argv[arg], "-c")) {
+         options.cleanup = true;
+      } else if (!strcmp(argv[arg], "-r")) {
+         options.scheduling.backward = true;
+      } else if (!strcmp(argv[arg], "-H")) {
+         options.scheduling.portfolio = true;
+      } else if (!strcmp(argv[arg], "-f")) {
+         options.fused = true;
+      } else if (!strcmp(argv[arg], "-t") || !strcmp(argv[arg], "--stats")) {
+         options.stats = StatsMode::TEXT;
+      } else if (!strcmp(argv[arg], "--stats=json")) {
+         options.stats = StatsMode::JSON;
+      } else if (!strcmp(argv[arg], "--report")) {
+         options.report = true;
+      } else if (!strcmp(argv[arg], "-e") || !strcmp(argv[arg], "-j") || !strcmp(argv[arg], "-k") || !strcmp(argv[arg], "-l") || !strcmp(argv[arg], "-T") || !strcmp(argv[arg], "-o")) {
+         long value = arg + 1 < argc ? atol(argv[arg + 1]) : 0;
+         if (value <= 0) {
+            std::cerr << "ERROR: " << argv[arg] << " requires a positive count." << std::endl;
+            return -1;
+         }
+         switch (argv[arg][1]) {
+            case 'e': options.maxErrors = value; break;
+            case 'j': options.threads = value; break;
+            case 'k': options.scheduling.registers = value; break;
+            case 'l': options.scheduling.beamStates = value; break;
+            case 'T': options.scheduling.beamMilliseconds = value; break;
+            case 'o': options.scheduling.optimalMilliseconds = value; break;
+         }
+         arg++;
+      } else {
+         std::cerr << "ERROR: Unknown option " << argv[arg] << "." << std::endl;
+         return -1;
+      }
+   }
+
+   if (arg >= argc) {
+      std::cerr << "ERROR: Must provide an input file." << std::endl;
+      return -1;
+   }
+
+   // Batch mode already keeps -j workers busy with whole blocks, so each block
+   // is parsed serially and its -r and -H candidates run on its worker
+   options.scheduling.threads = options.threads;
+   if (options.batch) {
+      options.parallel = false;
+      options.scheduling.threads = 1;
+      scheduleBatch(collectInputs(argv + arg, argc - arg), options);
    } else {
-      schedule(argv[1]);      
+      schedule(argv[arg], options, std::cout, std::cerr);
    }
 
    return 0;
@@ -0,0 +1,96 @@
+#include <Optimizer.hpp>
+#include <Renamer.hpp>
+#include <Operation.hpp>
+#include <vector>
+
+long Optimizer::optimize(InternalRepresentation& rep) {
+
+    std::vector<Operation>& operations = rep.operations;
+    int registers = rep.maxSR + 1;
+
+    // Fold arithmetic on known constants into loadI. A loadI constant is a
+    // non-negative int, so other results stay arithmetic (their value is
+    // still tracked for the operations that use it). A use of a register
+    // with no prior definition is rejected here, as the renamer would, since
+    // removing a dead operation could hide it.
+    std::vector<int64_t> value(registers, UNKNOWN);
+    std::vector<char> defined(registers, false);
+    long folded = 0;
+    for (Operation& op : operations) {
+        Operand* uses[2] = {};
+        int numUses = op.getUses(uses);
+        for (int u = 0; u < numUses; u++) {
+            if (!defined[uses[u]->SR]) {
+                throw RenamingFailedException(Renamer::UNDEFINED_USE);
+            }
+        }
+
+        int64_t result = UNKNOWN;
+        switch (op.opcode) {
+            case Opcode::LOADI:
+                result = op.op1.SR;
+                break;
+            case Opcode::ADD:
+            case Opcode::SUB:
+            case Opcode::MULT:
+            case Opcode::LSHIFT:
+            case Opcode::RSHIFT:
+                result = fold(op.opcode, value[op.op1.SR], value[op.op2.SR]);
+                if (result >= 0) {
+                    op.opcode = Opcode::LOADI;
+                    op.op1 = Operand();
+                    op.op1.SR = (int) result;
+                    op.op2 = Operand();
+                    folded++;
+                }
+                break;
+            default:
+                break;
+        }
+
+        // Defined after the uses, which may read the same register
+        if (op.opcode != Opcode::STORE && op.op3.SR != -1) {
+            value[op.op3.SR] = result;
+            defined[op.op3.SR] = true;
+        }
+    }
+
+    // Remove loadI and arithmetic whose result is never used, walking
+    // backward so that the operands of a removed operation can die too.
+    // Nothing is live at the end of the block.
+    std::vector<char> live(registers, false);
+    std::vector<char> dead(operations.size(), false);
+    long removed = 0;
+    for (size_t i = operations.size(); i-- > 0; ) {
+        Operation& op = operations[i];
+        if (op.opcode != Opcode::STORE && op.op3.SR != -1) {
+            if (!live[op.op3.SR] && op.opcode != Opcode::LOAD) {
+                dead[i] = true;
+                removed++;
+                continue;
+            }
+            live[op.op3.SR] = false;
+        }
+
+        Operand* uses[2] = {};
+        int numUses = op.getUses(uses);
+        for (int u = 0; u < numUses; u++) {
+            live[uses[u]->SR] = true;
+        }
+    }
+
+    // Compact the survivors in order
+    size_t kept = 0;
+    for (size_t i = 0; i < operations.size(); i++) {
+        if (!dead[i]) {
+            operations[kept++] = operations[i];
+        }
+    }
+    operations.resize(kept);
+
+    if (stats != nullptr) {
+        stats->folded = folded;
+        stats->removed = removed;
+    }
+    return removed;
+}
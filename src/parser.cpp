@@ -1,227 +1,220 @@
 #include <Parser.hpp>
 #include <Scanner.hpp>
 #include <Operation.hpp>
-#include <iostream>
 #include <algorithm>
 
 InternalRepresentation Parser::parse() {
     
     std::vector<Operation> operations;
     int maxSR = -1;
-    int error = 0;
+    errors = 0;
+    ParseStatus status = ParseStatus::OK;
 
     Token token = scanner.nextToken();    
-    while (token.category != Category::CAT_EOF) {
+    while (token.category != Category::CAT_EOF && !diagnostics.full()) {
         this->line++;
+
+        Operation op;
+        op.opcode = static_cast<Opcode>(token.lexeme);
+
         switch (token.category) {
             case Category::CAT_MEMOP:
-                try {
-                    Operation op = this->finishMEMOP(static_cast<Opcode>(token.lexeme));
+                status = this->finishMEMOP(op);
+                if (status == ParseStatus::OK) {
                     operations.push_back(op);
                     maxSR = std::max({maxSR, op.op1.SR, op.op3.SR});
-                } catch (const InvalidTokenException& e) {
-                    this->handleInvalidToken(e);
-                    error++;
-                }    
+                }
                 break;
             case Category::CAT_LOADI:
-                try {
-                    Operation op = this->finishLOADI(static_cast<Opcode>(token.lexeme));
+                status = this->finishLOADI(op);
+                if (status == ParseStatus::OK) {
                     operations.push_back(op);
                     maxSR = std::max({maxSR, op.op3.SR});
-                } catch (const InvalidTokenException& e) {
-                    this->handleInvalidToken(e);
-                    error++;
-                }  
+                }
                 break;
             case Category::CAT_ARITHOP:
-                try {
-                    Operation op = this->finishARITHOP(static_cast<Opcode>(token.lexeme));
+                status = this->finishARITHOP(op);
+                if (status == ParseStatus::OK) {
                     operations.push_back(op);
                     maxSR = std::max({maxSR, op.op1.SR, op.op2.SR, op.op3.SR});
-                } catch (const InvalidTokenException& e) {
-                    this->handleInvalidToken(e);
-                    error++;
-                }  
+                }
                 break;
             case Category::CAT_OUTPUT:
-                try {
-                    operations.push_back(this->finishOUTPUT(static_cast<Opcode>(token.lexeme)));
-                } catch (const InvalidTokenException& e) {
-                    this->handleInvalidToken(e);
-                    error++;
-                }  
+                status = this->finishOUTPUT(op);
+                if (status == ParseStatus::OK) {
+                    operations.push_back(op);
+                }
                 break;
             case Category::CAT_NOP:
-                try {
-                    operations.push_back(this->finishNOP(static_cast<Opcode>(token.lexeme)));
-                } catch (const InvalidTokenException& e) {
-                    this->handleInvalidToken(e);
-                    error++;
-                }  
+                status = this->finishNOP(op);
+                if (status == ParseStatus::OK) {
+                    operations.push_back(op);
+                }
                 break;
             case Category::CAT_EOL:
+                status = ParseStatus::OK;
                 break;
             default:
-                this->handleInvalidToken(InvalidTokenException(token, "Operation starts with an invalid opcode."));
-                error++;
+                status = this->invalidToken(token, "Operation starts with an invalid opcode.");
+        }
+
+        if (status != ParseStatus::OK) {
+            errors++;
+            if (status == ParseStatus::UNEXPECTED_EOF) {
+                break;
+            }
         }
         token = scanner.nextToken();
     }
 
-    if (error > 0) {
-        throw ParseFailedException("Parse failed with " + std::to_string(error) + " errors.");
+    if (errors > 0) {
+        throw ParseFailedException("Parse failed with " + std::to_string(errors) + " errors.");
     }
-    return {operations, maxSR};
+
+    InternalRepresentation rep;
+    rep.operations = std::move(operations);
+    rep.maxSR = maxSR;
+    rep.registerNames = registers.names();
+    return rep;
 }
 
-Operation Parser::finishMEMOP(Opcode opcode) {
-    
-    Operation op;
-    op.opcode = opcode;
+ParseStatus Parser::finishMEMOP(Operation& op) {
 
     Token token = scanner.nextToken();
     if (token.category != Category::CAT_REGISTER) {
-        throw InvalidTokenException(token, "Missing source register in MEMOP.");
+        return this->invalidToken(token, "Missing source register in MEMOP.");
     }
-    op.op1.SR = token.lexeme;
+    op.op1.SR = registers.index(token.lexeme);
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_INTO) {
-        throw InvalidTokenException(token, "Missing \"=>\" in MEMOP.");
+        return this->invalidToken(token, "Missing \"=>\" in MEMOP.");
     }
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_REGISTER) {
-        throw InvalidTokenException(token, "Missing target register in MEMOP.");
+        return this->invalidToken(token, "Missing target register in MEMOP.");
     }
-    op.op3.SR = token.lexeme;
+    op.op3.SR = registers.index(token.lexeme);
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_EOL) {
-        throw InvalidTokenException(token, "Extra token at end of line in MEMOP.");
+        return this->invalidToken(token, "Extra token at end of line in MEMOP.");
     }
 
-    return op;
+    return ParseStatus::OK;
 }
 
-Operation Parser::finishLOADI(Opcode opcode) {
-    
-    Operation op;
-    op.opcode = opcode;
+ParseStatus Parser::finishLOADI(Operation& op) {
 
     Token token = scanner.nextToken();
     if (token.category != Category::CAT_CONSTANT) {
-        throw InvalidTokenException(token, "Missing constant in LOADI.");
+        return this->invalidToken(token, "Missing constant in LOADI.");
     }
     op.op1.SR = token.lexeme;
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_INTO) {
-        throw InvalidTokenException(token, "Missing \"=>\" in LOADI.");
+        return this->invalidToken(token, "Missing \"=>\" in LOADI.");
     }
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_REGISTER) {
-        throw InvalidTokenException(token, "Missing target register in LOADI.");
+        return this->invalidToken(token, "Missing target register in LOADI.");
     }
-    op.op3.SR = token.lexeme;
+    op.op3.SR = registers.index(token.lexeme);
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_EOL) {
-        throw InvalidTokenException(token, "Extra token at end of line in LOADI.");
+        return this->invalidToken(token, "Extra token at end of line in LOADI.");
     }
 
-    return op;
+    return ParseStatus::OK;
 }
 
-Operation Parser::finishARITHOP(Opcode opcode) {
-    
-    Operation op;
-    op.opcode = opcode;
+ParseStatus Parser::finishARITHOP(Operation& op) {
 
     Token token = scanner.nextToken();
     if (token.category != Category::CAT_REGISTER) {
-        throw InvalidTokenException(token, "Missing first source register in ARITHOP.");
+        return this->invalidToken(token, "Missing first source register in ARITHOP.");
     }
-    op.op1.SR = token.lexeme;
+    op.op1.SR = registers.index(token.lexeme);
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_COMMA) {
-        throw InvalidTokenException(token, "Missing \",\" in ARITHOP.");
+        return this->invalidToken(token, "Missing \",\" in ARITHOP.");
     }
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_REGISTER) {
-        throw InvalidTokenException(token, "Missing second source register in ARITHOP.");
+        return this->invalidToken(token, "Missing second source register in ARITHOP.");
     }
-    op.op2.SR = token.lexeme;
+    op.op2.SR = registers.index(token.lexeme);
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_INTO) {
-        throw InvalidTokenException(token, "Missing \"=>\" in ARITHOP.");
+        return this->invalidToken(token, "Missing \"=>\" in ARITHOP.");
     }
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_REGISTER) {
-        throw InvalidTokenException(token, "Missing target register in ARITHOP.");
+        return this->invalidToken(token, "Missing target register in ARITHOP.");
     }
-    op.op3.SR = token.lexeme;
+    op.op3.SR = registers.index(token.lexeme);
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_EOL) {
-        throw InvalidTokenException(token, "Extra token at end of line in ARITHOP.");
+        return this->invalidToken(token, "Extra token at end of line in ARITHOP.");
     }
 
-    return op;
+    return ParseStatus::OK;
 }
 
-Operation Parser::finishOUTPUT(Opcode opcode) {
-    
-    Operation op;
-    op.opcode = opcode;
+ParseStatus Parser::finishOUTPUT(Operation& op) {
 
     Token token = scanner.nextToken();
     if (token.category != Category::CAT_CONSTANT) {
-        throw InvalidTokenException(token, "Missing constant in OUTPUT.");
+        return this->invalidToken(token, "Missing constant in OUTPUT.");
     }
     op.op1.SR = token.lexeme;
 
     token = scanner.nextToken();
     if (token.category != Category::CAT_EOL) {
-        throw InvalidTokenException(token, "Extra token at end of line in OUTPUT.");
+        return this->invalidToken(token, "Extra token at end of line in OUTPUT.");
     }
 
-    return op;
+    return ParseStatus::OK;
 }
 
-Operation Parser::finishNOP(Opcode opcode) {
-    Operation op;
-    op.opcode = opcode;
+ParseStatus Parser::finishNOP(Operation& op) {
 
     Token token = scanner.nextToken();
     if (token.category != Category::CAT_EOL) {
-        throw InvalidTokenException(token, "Extra token at end of line in NOP.");
+        return this->invalidToken(token, "Extra token at end of line in NOP.");
     }
 
-    return op;
+    return ParseStatus::OK;
 }
 
-void Parser::readToNextLine () {
+ParseStatus Parser::readToNextLine () {
     Token token = scanner.nextToken();
     while (token.category != Category::CAT_EOL) {
         if (token.category == Category::CAT_EOF) {
-            throw new UnexpectedEOFException("Unexpected EOF at line " + std::to_string(this->line));
+            diagnostics.error(this->line, "Unexpected EOF.");
+            return ParseStatus::UNEXPECTED_EOF;
         }
         token = scanner.nextToken();
     }
+    return ParseStatus::ERROR;
 }
 
-void Parser::handleInvalidToken(const InvalidTokenException& e) {
-    std::cerr << "ERROR " << this->line << ": "  << e.what() << std::endl;
-    if (e.getToken().category == Category::CAT_EOF) {
-        throw new UnexpectedEOFException("Unexpected EOF at line " + std::to_string(this->line));
-    } else if (e.getToken().category != Category::CAT_EOL) {
-        this->readToNextLine();
+ParseStatus Parser::invalidToken(const Token& token, const char* message) {
+    diagnostics.error(this->line, message);
+    if (token.category == Category::CAT_EOF) {
+        diagnostics.error(this->line, "Unexpected EOF.");
+        return ParseStatus::UNEXPECTED_EOF;
+    } else if (token.category != Category::CAT_EOL) {
+        return this->readToNextLine();
     }
+    return ParseStatus::ERROR;
 }
@@ -3,77 +3,136 @@
 #include <algorithm>
 #include <vector>
 
+// Rename operations [begin, end) walking backward from the state at end
+static void renameRange(std::vector<Operation>& operations, size_t begin, size_t end, RenameState& state) {
+
+    for (size_t position = end; position-- > begin; ) {
+        Renamer::renameOperation(operations[position], position + 1, state);
+    }
+}
+
 void Renamer::rename(InternalRepresentation& rep){
 
-    int VRName = 0;
-    int index = rep.operations.size();
-    int maxLive = 0;
-    int live = 0;
+    int segments = pool != nullptr ? std::min<long>(pool->size(), rep.operations.size() / MIN_SEGMENT_SIZE) : 1;
+    if (segments > 1) {
+        renameParallel(rep, segments);
+        return;
+    }
+
+    RenameState state (rep.maxSR + 1);
+    renameRange(rep.operations, 0, rep.operations.size(), state);
+    finish(rep, state);
+}
 
-    int SRToVR [rep.maxSR + 1];
-    int LU [rep.maxSR + 1];
-    for (int i = 0; i <= rep.maxSR; i ++) {
-        SRToVR[i] = -1;
-        LU[i] = -1;
+void Renamer::finish(InternalRepresentation& rep, const RenameState& state) {
+    if (state.live > 0) {
+        throw RenamingFailedException(UNDEFINED_USE);
     }
 
-    for (auto op = rep.operations.rbegin(); op != rep.operations.rend(); ++op) {
+    rep.maxVR = state.VRName;
+    rep.maxLive = state.maxLive;
+}
 
-        Operand& o = op->op3;
-        if (op->opcode != Opcode::STORE && o.SR != -1) {
-            if (SRToVR[o.SR] == -1) {
-                SRToVR[o.SR] = VRName++;
-                live ++;
-            }
-            o.VR = SRToVR[o.SR];
-            o.NU = LU[o.SR];
-            SRToVR[o.SR] = -1;
-            LU[o.SR]= -1;
-            live --;
-        }
+/*
+ * Renaming in three passes over contiguous segments:
+ *
+ * 1. Each segment is renamed on its own, starting with nothing live. This
+ *    yields its number of local names, and for every register it touches the
+ *    first (bottom-most) local name, the name live on entry to the segment
+ *    and the first use in the segment.
+ * 2. The summaries are composed serially from the last segment to the first.
+ *    A register's bottom-most name continues the live range from below when
+ *    the register is live out of the segment; every other local name is a
+ *    fresh VR. This gives each segment's live-out tables and its first VR.
+ * 3. Each segment is renamed again from its exact live-out state, which
+ *    assigns the same VRs, NUs and live counts as one serial sweep.
+ */
+void Renamer::renameParallel(InternalRepresentation& rep, int segments) {
+
+    struct Summary {
+        int names;
+        std::vector<int> touched;
+        std::vector<int> bottomName;
+        std::vector<int> entryName;
+        std::vector<int> firstUse;
+    };
+
+    int registers = rep.maxSR + 1;
+    size_t size = rep.operations.size();
+    std::vector<size_t> bounds (segments + 1);
+    for (int s = 0; s <= segments; s++) {
+        bounds[s] = size * s / segments;
+    }
 
-        std::vector<Operand*> uses;
-        switch (op->opcode) {
-            case Opcode::LOAD:
-                uses.push_back(&op->op1);
-                break;
-            case Opcode::STORE:
-                uses.push_back(&op->op1);
-                uses.push_back(&op->op3);
-                break;
-            case Opcode::ADD:
-            case Opcode::SUB:
-            case Opcode::MULT:
-            case Opcode::LSHIFT:
-            case Opcode::RSHIFT:
-                uses.push_back(&op->op1);
-                uses.push_back(&op->op2);
-                break;
-            default:
-                break;
+    // Summarise every segment
+    std::vector<Summary> summaries (segments);
+    pool->parallelFor(segments, [&] (int s) {
+        RenameState state (registers);
+        state.track = true;
+        state.firstName.assign(registers, -1);
+        renameRange(rep.operations, bounds[s], bounds[s + 1], state);
+
+        Summary& summary = summaries[s];
+        summary.names = state.VRName;
+        summary.touched = std::move(state.touched);
+        for (int SR : summary.touched) {
+            summary.bottomName.push_back(state.firstName[SR]);
+            summary.entryName.push_back(state.SRToVR[SR]);
+            summary.firstUse.push_back(state.LU[SR]);
         }
+    });
+
+    // Compose summaries from the bottom of the block upward
+    RenameState state (registers);
+    std::vector<RenameState> liveOut;
+    std::vector<int> base (segments);
+    liveOut.reserve(segments);
+    for (int s = segments - 1; s >= 0; s--) {
+        const Summary& summary = summaries[s];
+        liveOut.push_back(state);
+        base[s] = state.VRName;
 
-        for (Operand* o: uses) {
-            if (SRToVR[o->SR] == -1) {
-                SRToVR[o->SR] = VRName++;
-                live ++;
+        // Local names that continue a live range from below
+        std::vector<int> continued;
+        for (size_t i = 0; i < summary.touched.size(); i++) {
+            if (state.SRToVR[summary.touched[i]] != -1) {
+                continued.push_back(summary.bottomName[i]);
             }
-            o->VR = SRToVR[o->SR];
-            o->NU = LU[o->SR];
         }
+        std::sort(continued.begin(), continued.end());
 
-        for (Operand* o: uses) {
-            LU[o->SR] = index;
-        }
-        index--;
+        auto globalName = [&] (int SR, int name) {
+            auto it = std::lower_bound(continued.begin(), continued.end(), name);
+            if (it != continued.end() && *it == name) {
+                return state.SRToVR[SR];
+            }
+            return base[s] + name - (int) (it - continued.begin());
+        };
 
-        maxLive = std::max(maxLive, live);
+        std::vector<int> entry (summary.touched.size());
+        for (size_t i = 0; i < summary.touched.size(); i++) {
+            int name = summary.entryName[i];
+            entry[i] = name == -1 ? -1 : globalName(summary.touched[i], name);
+        }
+        for (size_t i = 0; i < summary.touched.size(); i++) {
+            int SR = summary.touched[i];
+            state.live += (entry[i] != -1) - (state.SRToVR[SR] != -1);
+            state.SRToVR[SR] = entry[i];
+            state.LU[SR] = summary.firstUse[i];
+        }
+        state.VRName += summary.names - continued.size();
     }
+    std::reverse(liveOut.begin(), liveOut.end());
 
-    if (live > 0) {
-        throw RenamingFailedException("Input block uses values from registers that have no prior definition.");
-    }
+    finish(rep, state);
 
-    rep.maxVR = VRName;
-    rep.maxLive = maxLive;
-}
\ No newline at end of file
+    // Rename every segment from its live-out state
+    pool->parallelFor(segments, [&] (int s) {
+        liveOut[s].VRName = base[s];
+        renameRange(rep.operations, bounds[s], bounds[s + 1], liveOut[s]);
+    });
+
+    for (const RenameState& segment : liveOut) {
+        rep.maxLive = std::max(rep.maxLive, segment.maxLive);
+    }
+}
@@ -1,86 +1,98 @@
 #include <Scanner.hpp>
 #include <TransitionTable.hpp>
-#include <fstream>
-#include <iostream>
+#include <cstring>
+#include <charconv>
 #include <algorithm>
 
-Scanner::Scanner(const std::string filename) {
-    file = std::ifstream (filename);
-    if (!file.is_open()){
-        throw FileNotFoundException("Failed to open file: " + filename);
-    }
-    TransitionTable table;
+Scanner::Scanner(const std::string filename, Diagnostics& diagnostics) : input(std::make_unique<InputBuffer>(filename)), diagnostics(diagnostics) {
+    buffer = input->data();
+    size = input->size();
+    index = 0;
+    line = 1;
+    tokens = 0;
+}
+
+Scanner::Scanner(const char* begin, size_t size, int firstLine, Diagnostics& diagnostics) : diagnostics(diagnostics) {
+    buffer = begin;
+    this->size = size;
     index = 0;
-    line = 0;
-    eof = false;
-    this->readLine();
+    line = firstLine;
+    tokens = 0;
 }
 
 Token Scanner::nextToken() {
 
     int currState;
     int nextState;
-    int first;
+    size_t first;
     unsigned char currChar;
     unsigned char nextChar;
     
-    if (eof) {
+    if (index >= size) {
         return Token(Category::CAT_EOF, -1); 
     }
+    tokens ++;
 
     currChar = buffer[index];
-    currState = table.table[0][currChar];
-    if (currState == -1) {
-        std::cerr << "ERROR " << this->line << ": \"" << currChar << "\" is not a valid word." << std::endl;
-        index = buffer.size() - 1;
-        return Token(Category::CAT_INVAL, -1); 
-    }
-
+    currState = TRANSITION_TABLE.next(0, currChar);
     while (currState == 0){
         index ++;
         currChar = buffer[index];
-        currState = table.table[0][currChar];
+        currState = TRANSITION_TABLE.next(0, currChar);
+    }
+
+    if (currState == -1) {
+        diagnostics.error(this->line, std::string_view(buffer + index, 1), "is not a valid word.");
+        index = endOfLine(index);
+        return Token(Category::CAT_INVAL, -1); 
     }
     first = index;
 
     index ++;
-    nextChar = buffer[index];
-    nextState = table.table[currState][nextChar];
 
-    while (nextState != -1) {
+    // Every token ends at or before a newline and the input always ends with
+    // one, so the walk never reads past the end of the buffer
+    while (currChar != '\n') {
+        nextChar = buffer[index];
+        nextState = TRANSITION_TABLE.next(currState, nextChar);
+        if (nextState == -1) {
+            break;
+        }
         index ++;
         currChar = nextChar;
         currState = nextState;
-        nextChar = buffer[index];
-        nextState = table.table[currState][nextChar];
     }
 
-    if (table.accepting.find(currState) != table.accepting.end()) {
-        Category category = table.stateToCategory[currState];
+    if (TRANSITION_TABLE.isAccepting(currState)) {
+        Category category = TRANSITION_TABLE.category[currState];
         if (category == Category::CAT_EOL) {
-            readLine();
+            line ++;
+        }
+        int lexeme = this->getLexeme(category, first);
+
+        // Numbers that do not fit in an int are reported like invalid words
+        if (lexeme == -1 && (category == Category::CAT_CONSTANT || category == Category::CAT_REGISTER)) {
+            diagnostics.error(this->line, std::string_view(buffer + first, index - first), "is out of range.");
+            index = endOfLine(index);
+            return Token(Category::CAT_INVAL, -1);
         }
-        return Token(category, this->getLexeme(category, first));
+        return Token(category, lexeme);
     } else {
-        int length = std::min<int>(index - first + 1, buffer.size() - first - 1);
-        std::cerr << "ERROR " << this->line << ": \"" << buffer.substr(first, length) << "\" is not a valid word." << std::endl;
-        index = buffer.size() - 1;
+        size_t eol = endOfLine(index);
+        size_t length = std::min(index - first + 1, eol - first);
+        diagnostics.error(this->line, std::string_view(buffer + first, length), "is not a valid word.");
+        index = eol;
         return Token(Category::CAT_INVAL, -1);
     }
 
 }
 
-void Scanner::readLine() {
-    if (!std::getline(file, buffer)) {
-        eof = true;
-        return;
-    }
-    buffer += "\n";
-    index = 0;
-    line ++;
+size_t Scanner::endOfLine(size_t from) const {
+    const void* eol = std::memchr(buffer + from, '\n', size - from);
+    return static_cast<const char*>(eol) - buffer;
 }
 
-int Scanner::getLexeme(Category category, int first) {
+int Scanner::getLexeme(Category category, size_t first) {
     switch (category) {
         case Category::CAT_MEMOP:
             if (buffer[first] == 's') {
@@ -108,10 +120,19 @@ int Scanner::getLexeme(Category category, int first) {
         case Category::CAT_NOP:
             return (int) Opcode::NOP; 
         case Category::CAT_CONSTANT:
-            return std::stoi(buffer.substr(first, index - first)); 
+            return decodeNumber(first, index); 
         case Category::CAT_REGISTER:
-            return std::stoi(buffer.substr(first + 1, index - first - 1)); 
+            return decodeNumber(first + 1, index); 
         default:
             return -1;
     }
+}
+
+int Scanner::decodeNumber(size_t first, size_t last) const {
+    int value;
+    auto [end, error] = std::from_chars(buffer + first, buffer + last, value);
+    if (error != std::errc() || end != buffer + last) {
+        return -1;
+    }
+    return value;
 }
\ No newline at end of file
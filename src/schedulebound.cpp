@@ -0,0 +1,66 @@
+#include <ScheduleBound.hpp>
+#include <algorithm>
+#include <climits>
+
+ScheduleBound::ScheduleBound(const DependenceGraph& graph, const Machine& machine)
+    : graph(graph), limited(machine.resources()), path(0) {
+
+    // Dependents always come later in program order
+    int n = graph.numNodes();
+    tail.assign(n + 1, 0);
+    for (int id = n; id >= 1; id--) {
+        tail[id] = machine.latency[(int) graph[id].op.opcode] - 1;
+        for (const auto& edge : graph.inEdges(id)) {
+            tail[id] = std::max(tail[id], edge.weight + tail[edge.to]);
+        }
+    }
+    head.resize(n + 1);
+    demand.resize(limited.size());
+    bounds.resize(limited.size());
+}
+
+int ScheduleBound::compute(const SearchState& state) {
+
+    path = std::max({state.finish, state.pathBound, state.cycle - 1});
+    for (auto& operations : demand) {
+        operations.clear();
+    }
+    for (int id = 1; id <= graph.numNodes(); id++) {
+        if (state.pending[id] == -1) {
+            continue;
+        }
+        head[id] = std::max(state.earliest[id], state.cycle);
+        for (const auto& edge : graph.outEdges(id)) {
+            if (state.pending[edge.to] != -1) {
+                head[id] = std::max(head[id], head[edge.to] + edge.weight);
+            }
+        }
+        path = std::max(path, head[id] + tail[id]);
+
+        Machine::OpcodeMask opcode = Machine::mask(graph[id].op.opcode);
+        for (size_t r = 0; r < limited.size(); r++) {
+            if (limited[r].opcodes & opcode) {
+                demand[r].push_back({head[id], tail[id]});
+            }
+        }
+    }
+
+    int bound = path;
+    for (size_t r = 0; r < limited.size(); r++) {
+        auto& operations = demand[r];
+        std::sort(operations.begin(), operations.end(), [] (const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+        int capacity = limited[r].capacity;
+        int shortest = INT_MAX;
+        bounds[r] = 0;
+        for (size_t k = 0; k < operations.size(); k++) {
+            shortest = std::min(shortest, operations[k].second);
+            int cycles = ((int) k + capacity) / capacity;
+            bounds[r] = std::max(bounds[r], operations[k].first + cycles - 1 + shortest);
+        }
+        bound = std::max(bound, bounds[r]);
+    }
+
+    return bound;
+}
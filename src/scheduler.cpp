@@ -1,115 +1,436 @@
 #include <Scheduler.hpp>
+#include <BeamSearch.hpp>
+#include <BranchAndBound.hpp>
+#include <Optimizer.hpp>
+#include <Renamer.hpp>
 #include <Operation.hpp>
-#include <unordered_map>
-#include <unordered_set>
-#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <future>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 Schedule Scheduler::schedule(InternalRepresentation& rep) {
 
     // Construct dependence graph
-    DependenceGraph graph = buildDependenceGraph(rep);
+    DependenceGraph graph;
+    {
+        PhaseTimer timer (stats, Stats::GRAPH);
+        graph = buildDependenceGraph(rep);
+    }
 
     // Compute priorities using maximum latency-weighted path
-    std::unordered_map<int, int> priorities = getPriorities(graph);
+    std::vector<int> priorities;
+    {
+        PhaseTimer timer (stats, Stats::PRIORITIES);
+        priorities = getPriorities(graph);
+    }
+
+    return finish(graph, priorities);
+}
+
+Schedule Scheduler::scheduleFused(InternalRepresentation& rep) {
+
+    DependenceGraph graph;
+    std::vector<int> priorities;
+    {
+        PhaseTimer timer (stats, Stats::FUSED);
+        graph = buildFused(rep, priorities);
+    }
+
+    return finish(graph, priorities);
+}
+
+Schedule Scheduler::finish(const DependenceGraph& graph, const std::vector<int>& priorities) {
+
+    // Schedule operations. Bottom-up scheduling and the other priority
+    // heuristics, if asked for, run alongside on as many threads as
+    // options.threads allows; the shortest schedule wins, the earliest
+    // candidate on a tie. Under a register limit, a schedule that stays
+    // within it beats any that does not.
+    auto better = [&] (const Schedule& candidate, const Schedule& best) {
+        if (options.registers > 0) {
+            bool fits = peakLive(candidate) <= options.registers;
+            if (fits != (peakLive(best) <= options.registers)) {
+                return fits;
+            }
+        }
+        return candidate.numCycles() < best.numCycles();
+    };
+    Schedule schedule;
+    int greedyCycles = 0;
+    int backwardCycles = 0;
+    const char* source = nullptr;
+    {
+        PhaseTimer timer (stats, Stats::SCHEDULE);
+
+        // At most options.threads schedules at once: this thread and as many
+        // helpers as that leaves. Candidates beyond them run on this thread
+        // when their result is collected.
+        int helpers = options.threads - 1;
+        auto policy = [&] { return helpers-- > 0 ? std::launch::async : std::launch::deferred; };
+
+        // Candidates run without stats, which are not shared between threads
+        std::vector<std::future<Schedule>> portfolio;
+        if (options.portfolio) {
+            for (int h = 1; h < (int) Heuristic::NUM_HEURISTICS; h++) {
+                portfolio.push_back(std::async(policy(), [&, h] {
+                    Scheduler candidate (nullptr, machine, options);
+                    return candidate.listSchedule(graph, candidate.getPriorities(graph, (Heuristic) h));
+                }));
+            }
+            source = heuristicName(Heuristic::CRITICAL_PATH);
+        }
+        std::future<Schedule> backward;
+        if (options.backward) {
+            backward = std::async(policy(), [&] { return backwardSchedule(graph); });
+        }
+
+        schedule = listSchedule(graph, priorities);
+        greedyCycles = schedule.numCycles();
+
+        for (size_t h = 0; h < portfolio.size(); h++) {
+            Schedule candidate = portfolio[h].get();
+            if (better(candidate, schedule)) {
+                schedule = std::move(candidate);
+                source = heuristicName((Heuristic) (h + 1));
+            }
+        }
+        if (options.backward) {
+            Schedule reversed = backward.get();
+            backwardCycles = reversed.numCycles();
+            if (better(reversed, schedule)) {
+                schedule = std::move(reversed);
+                source = "backward";
+            }
+        }
+    }
+
+    // Look for a shorter schedule, keeping the greedy one otherwise
+    if (options.beamStates > 0 || options.beamMilliseconds > 0) {
+        PhaseTimer timer (stats, Stats::SEARCH);
+        BeamSearch beam (graph, priorities, machine, options.beamStates, options.beamMilliseconds, options.beamWidth);
+        Schedule improved;
+        if (beam.improve(schedule.numCycles(), improved) && better(improved, schedule)) {
+            schedule = std::move(improved);
+            source = "beam-search";
+        }
+        if (stats != nullptr) {
+            stats->searchStates += beam.statesExplored();
+        }
+    }
+
+    // Search small blocks for a provably shortest schedule, within a deadline
+    if (options.optimalMilliseconds > 0) {
+        PhaseTimer timer (stats, Stats::SEARCH);
+        BranchAndBound exact (graph, priorities, machine, options.optimalMilliseconds);
+        Schedule improved;
+        if (exact.improve(schedule.numCycles(), improved) && better(improved, schedule)) {
+            schedule = std::move(improved);
+            source = "branch-and-bound";
+        }
+        if (stats != nullptr) {
+            stats->searchStates += exact.statesExplored();
+            stats->optimal = exact.proven();
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->greedyCycles = greedyCycles;
+        stats->backwardCycles = backwardCycles;
+        stats->heuristic = source;
+        stats->nodes = graph.numNodes();
+        stats->edges = graph.numEdges();
+        stats->cycles = schedule.numCycles();
+        stats->peakLive = peakLive(schedule);
+        for (const Operation& op : schedule.slots) {
+            stats->nopSlots += op.opcode == Opcode::NOP;
+        }
+    }
+
+    return schedule;
+}
+
+// Distinct virtual registers read by an operation
+static int usedRegisters(const Operation& op, int registers[2]) {
+    Operation copy = op;
+    Operand* uses[2] = {};
+    int numUses = copy.getUses(uses);
+    int count = 0;
+    for (int i = 0; i < numUses; i++) {
+        if (count == 0 || uses[i]->VR != registers[0]) {
+            registers[count++] = uses[i]->VR;
+        }
+    }
+    return count;
+}
+
+// Virtual register defined by an operation, or -1
+static int definedRegister(const Operation& op) {
+    return op.opcode != Opcode::STORE ? op.op3.VR : -1;
+}
+
+// Number of uses of every virtual register in a set of operations
+template<typename Operations>
+static std::vector<int> countUses(const Operations& operations) {
+    std::vector<int> uses;
+    for (const Operation& op : operations) {
+        int registers[2];
+        int count = usedRegisters(op, registers);
+        for (int i = 0; i < count; i++) {
+            if (registers[i] >= (int) uses.size()) {
+                uses.resize(registers[i] + 1, 0);
+            }
+            uses[registers[i]]++;
+        }
+    }
+    return uses;
+}
+
+Schedule Scheduler::listSchedule(const DependenceGraph& graph, const std::vector<int>& priorities) {
+
+    // Pick the specialisation once, outside the scheduling loop
+    if (options.registers > 0) {
+        return listScheduleFor<0, true>(graph, priorities);
+    }
+    switch (machine.width) {
+        case 1: return listScheduleFor<1>(graph, priorities);
+        case 2: return listScheduleFor<2>(graph, priorities);
+        case 3: return listScheduleFor<3>(graph, priorities);
+        case 4: return listScheduleFor<4>(graph, priorities);
+        default: return listScheduleFor<0>(graph, priorities);
+    }
+}
+
+template<int Width, bool Pressure>
+Schedule Scheduler::listScheduleFor(const DependenceGraph& graph, const std::vector<int>& priorities) {
 
-    // Initialize scheduling variables
+    const int width = Width > 0 ? Width : machine.width;
+    constexpr int SLOTS = Width > 0 ? Width : Machine::MAX_WIDTH;
+    const unsigned allUnits = (1u << width) - 1;
+
+    // Units that can execute each opcode, and per-cycle issue limits
+    unsigned unitsFor[Machine::NUM_OPCODES];
+    for (int i = 0; i < Machine::NUM_OPCODES; i++) {
+        unitsFor[i] = machine.unitsFor((Opcode) i);
+    }
+    const int* limit = machine.limit;
+    const int* latency = machine.latency;
+
+    // Initialize scheduling variables (indexed by node id)
     int cycle = 1;
-    std::unordered_set<int> active;
-    std::unordered_map<int, int> dependencies;
-    for (const auto& [id, node] : graph.nodes) {
-        dependencies[id] = node->outEdges.size();
+    std::vector<int> dependencies(graph.numNodes() + 1, 0);
+    for (int id = 1; id <= graph.numNodes(); id++) {
+        dependencies[id] = graph.outEdges(id).size();
     }
-    std::unordered_map<int, int> scheduledCycle;
+    std::vector<int> defer;
+    long pushes = 0, deferrals = 0;
     Schedule schedule;
+    schedule.width = width;
+    schedule.slots.reserve(graph.numNodes() * 2);
+
+    // Multi-cycle operations in flight, bucketed by the cycle they complete in
+    RetirementWheel wheel (machine.maxLatency());
+
+    // Under register pressure: uses left of each virtual register and the
+    // node defining it, the number of values defined and still to be used,
+    // and the ready operations that would not add to them. Operations can be
+    // taken from either queue, so issued ones are skipped when popped.
+    std::vector<int> remaining;
+    std::vector<int> definer;
+    std::vector<char> issued;
+    std::vector<int> deferEnding;
+    OperationPriorityQueue ending;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> inOrder;
+    int live = 0;
+    if constexpr (Pressure) {
+        std::vector<Operation> operations;
+        operations.reserve(graph.numNodes());
+        for (int id = 1; id <= graph.numNodes(); id++) {
+            operations.push_back(graph[id].op);
+        }
+        remaining = countUses(operations);
+        definer.resize(remaining.size(), 0);
+        for (int id = 1; id <= graph.numNodes(); id++) {
+            int def = definedRegister(graph[id].op);
+            if (def >= 0 && def < (int) definer.size()) {
+                definer[def] = id;
+            }
+        }
+        issued.resize(graph.numNodes() + 1, false);
+    }
+
+    // Change in live values if an operation issued now
+    auto liveChange = [&] (int id) {
+        int registers[2];
+        int count = usedRegisters(graph[id].op, registers);
+        int change = 0;
+        for (int i = 0; i < count; i++) {
+            change -= remaining[registers[i]] == 1;
+        }
+        int def = definedRegister(graph[id].op);
+        return change + (def >= 0 && def < (int) remaining.size() && remaining[def] > 0);
+    };
+
+    // Whether an operation reads a virtual register
+    auto reads = [&] (int id, int vr) {
+        int registers[2];
+        int count = usedRegisters(graph[id].op, registers);
+        return (count > 0 && registers[0] == vr) || (count > 1 && registers[1] == vr);
+    };
+
+    // Account for an operation placed in this cycle. When a value is down to
+    // its last use, that use may now end a live range.
+    auto track = [&] (int id) {
+        live += liveChange(id);
+        issued[id] = true;
+        int registers[2];
+        int count = usedRegisters(graph[id].op, registers);
+        for (int i = 0; i < count; i++) {
+            if (--remaining[registers[i]] == 1) {
+                for (const auto& edge : graph.inEdges(definer[registers[i]])) {
+                    if (!issued[edge.to] && dependencies[edge.to] == 0 && reads(edge.to, registers[i]) && liveChange(edge.to) <= 0) {
+                        ending.push({edge.to, priorities[edge.to]});
+                    }
+                }
+            }
+        }
+    };
+
+    auto skipIssued = [&] (OperationPriorityQueue& queue) {
+        while (!queue.empty() && issued[queue.top().id]) {
+            queue.pop();
+        }
+    };
 
     // Initialize ready queue
     OperationPriorityQueue ready;
-    for (const auto& [id, node] : graph.nodes) {
-        if (node->outEdges.empty() && id != graph.getUndefined()) {
-            ready.push({id, priorities[id]});
-            graph.nodes[id]->data.status = Status::READY;
+    auto makeReady = [&] (int id) {
+        ready.push({id, priorities[id]});
+        pushes++;
+        if constexpr (Pressure) {
+            if (liveChange(id) <= 0) {
+                ending.push({id, priorities[id]});
+            }
+            inOrder.push(id);
+        }
+    };
+    for (int id = 1; id <= graph.numNodes(); id++) {
+        if (graph.outEdges(id).empty()) {
+            makeReady(id);
         }
     }
 
-    // Schedule operations based on priorities
-    while (!ready.empty() || !active.empty()) {
-
-        // Pick an operation for each functional unit
-        int f0 = -1, f1 = -1;
-        bool output = false;
-        std::vector<int> defer;
+    // Release the dependences of an operation with the given edge weights. A
+    // dependent becomes ready exactly once, when its last dependence is released.
+    auto release = [&] (int id, bool multiCycle) {
+        for (const auto& edge : graph.inEdges(id)) {
+            if ((edge.weight > 1) == multiCycle && --dependencies[edge.to] == 0) {
+                makeReady(edge.to);
+            }
+        }
+    };
+
+    // Issue an operation: single-cycle dependences are satisfied next cycle,
+    // the rest when the operation completes
+    auto issue = [&] (int id) {
+        release(id, false);
+        int cycles = latency[(int) graph[id].op.opcode];
+        if (cycles > 1) {
+            wheel.insert(cycle + cycles, id);
+        }
+        return graph[id].op;
+    };
 
-        while (f0 == -1 || f1 == -1) {
+    // Schedule operations based on priorities
+    while (!ready.empty() || !wheel.empty()) {
 
-            // If no ready operations, break
-            if (ready.empty()) {
+        if constexpr (Pressure) {
+            skipIssued(ready);
+            if (ready.empty() && wheel.empty()) {
                 break;
             }
+        }
 
-            // Get the highest priority operation
-            OperationPriority op = ready.top();
-            ready.pop();
+        // If nothing is ready, skip ahead to the next completion in one step
+        if (ready.empty()) {
+            int next = wheel.nextEvent(cycle);
+            schedule.slots.insert(schedule.slots.end(), (size_t) (next - cycle) * width, NOP_OPERATION);
+            cycle = next;
+            for (int id : wheel.take(cycle)) {
+                release(id, true);
+            }
+            continue;
+        }
 
-            Opcode opcode = graph.nodes[op.id]->data.op.opcode;
-
-            // Use functional unit f0 for LOAD and STORE
-            if (opcode == Opcode::LOAD || opcode == Opcode::STORE) {
-
-                // Assign to f0 if available
-                if (f0 == -1) {
-                    f0 = op.id;   
-                } 
-                
-                // Otherwise, try to swap f0 to f1 if f1 is available
-                else if (f1 == -1 && graph.nodes[f0]->data.op.opcode != Opcode::LOAD && graph.nodes[f0]->data.op.opcode != Opcode::STORE){
-                    f1 = f0;
-                    f0 = op.id;
-                } 
-                
-                // Otherwise, defer operation
-                else {
-                    defer.push_back(op.id);
+        // Pick an operation for each functional unit
+        CycleAssignment<SLOTS> units;
+        defer.clear();
+
+        if (Pressure && live + width > options.registers) {
+
+            // Close to the register limit, take operations that end as many
+            // live ranges as they start first, then define values only while
+            // under the limit
+            deferEnding.clear();
+            while (units.busy != allUnits && !ending.empty()) {
+                int id = ending.top().id;
+                ending.pop();
+                if (issued[id]) {
+                    continue;
                 }
-            } 
-            
-            // Use functional unit f1 for MULT
-            else if (opcode == Opcode::MULT) {
-                
-                // Assign to f1 if available
-                if (f1 == -1) {
-                    f1 = op.id;
-                } 
-                
-                // Otherwise, try to swap f1 to f0 if f0 is available
-                else if (f0 == -1 && graph.nodes[f1]->data.op.opcode != Opcode::MULT) {
-                    f0 = f1;
-                    f1 = op.id;
-                } 
-                
-                // Otherwise, defer operation
-                else {
-                    defer.push_back(op.id);
+                if (units.place(id, (int) graph[id].op.opcode, unitsFor, limit)) {
+                    track(id);
+                } else {
+                    deferEnding.push_back(id);
                 }
-            } 
-            
-            // IF OUTPUT operation, there can be at most one per cycle
-            else if (opcode == Opcode::OUTPUT) {
-                if (!output) {
-                    if (f0 == -1) f0 = op.id;
-                    else if (f1 == -1) f1 = op.id;
-                    output = true;
+            }
+            for (int id : deferEnding) {
+                ending.push({id, priorities[id]});
+            }
+            while (units.busy != allUnits && live < options.registers && !ready.empty()) {
+                int id = ready.top().id;
+                ready.pop();
+                if (issued[id]) {
+                    continue;
+                }
+                if (units.place(id, (int) graph[id].op.opcode, unitsFor, limit)) {
+                    track(id);
                 } else {
+                    defer.push_back(id);
+                }
+            }
+
+            // Wait for operations in flight rather than exceed the limit. With
+            // nothing in flight, fall back on program order, which never had
+            // more than maxLive values live.
+            while (!inOrder.empty() && issued[inOrder.top()]) {
+                inOrder.pop();
+            }
+            if (units.busy == 0 && wheel.empty() && !inOrder.empty()) {
+                int id = inOrder.top();
+                units.place(id, (int) graph[id].op.opcode, unitsFor, limit);
+                track(id);
+            }
+
+        } else {
+            while (units.busy != allUnits && !ready.empty()) {
+
+                // Get the highest priority operation
+                OperationPriority op = ready.top();
+                ready.pop();
+                if (Pressure && issued[op.id]) {
+                    continue;
+                }
+
+                // Defer it if no unit can take it this cycle
+                if (!units.place(op.id, (int) graph[op.id].op.opcode, unitsFor, limit)) {
                     defer.push_back(op.id);
+                } else if constexpr (Pressure) {
+                    track(op.id);
                 }
-            } 
-            
-            // Use any available functional unit for other operations
-            else {
-                if (f0 == -1) f0 = op.id;
-                else if (f1 == -1) f1 = op.id;
-                else defer.push_back(op.id);
             }
         }
 
@@ -117,146 +438,288 @@ Schedule Scheduler::schedule(InternalRepresentation& rep) {
         for (int id : defer) {
            ready.push({id, priorities[id]});
         }
+        deferrals += defer.size();
+
+        // Issue the selected operations, or NOPs for idle units
+        size_t slot = schedule.slots.size();
+        schedule.slots.resize(slot + width, NOP_OPERATION);
+        for (int u = 0; u < width; u++) {
+            if (units.busy & (1u << u)) {
+                schedule.slots[slot + u] = issue(units.unit[u]);
+            }
+        }
 
-        // Insert operations into active set and schedule
-        Operation op0, op1;
+        // Next cycle, retiring operations that complete in it
+        cycle++;
+        for (int id : wheel.take(cycle)) {
+            release(id, true);
+        }
+    }
 
-        // If an operation was assigned to f0
-        if (f0 != -1) { 
+    if (stats != nullptr) {
+        stats->readyPushes += pushes;
+        stats->deferrals += deferrals;
+    }
 
-            // Mark operation in f0 as scheduled and active
-            scheduledCycle[f0] = cycle;
-            active.insert(f0);
-            graph.nodes[f0]->data.status = Status::ACTIVE;
+    return schedule;
+}
 
-            // Adjust dependencies of dependent operations
-            for (const auto& edge : graph.nodes[f0]->inEdges) {
-                if (edge.weight == 1){
-                    dependencies[edge.to]--;
-                }
+int Scheduler::peakLive(const Schedule& schedule) {
+
+    std::vector<int> remaining = countUses(schedule.slots);
+    int live = 0, peak = 0;
+    for (size_t c = 0; c < schedule.numCycles(); c++) {
+        for (int u = 0; u < schedule.width; u++) {
+            const Operation& op = schedule.cycle(c)[u];
+            int registers[2];
+            int count = usedRegisters(op, registers);
+            for (int i = 0; i < count; i++) {
+                live -= --remaining[registers[i]] == 0;
             }
-
-            // Assign operation in f0 to op0
-            op0 = graph.nodes[f0]->data.op;
-            
-        } else {
-
-            // Otherwise, schedule a NOP
-            op0 = {Opcode::NOP, {}, {}, {}};
+            int def = definedRegister(op);
+            live += def >= 0 && def < (int) remaining.size() && remaining[def] > 0;
         }
+        peak = std::max(peak, live);
+    }
 
-        // If an operation was assigned to f1
-        if (f1 != -1) { 
+    return peak;
+}
 
-            // Mark operation in f1 as scheduled and active
-            scheduledCycle[f1] = cycle; 
-            active.insert(f1); 
-            graph.nodes[f1]->data.status = Status::ACTIVE;
+/*
+ * Bottom-up list scheduling. Cycles are filled from the end of the block
+ * backward: an operation is ready once everything that depends on it has been
+ * placed, no earlier than each dependent's reverse cycle plus the edge weight,
+ * and no earlier than its own latency allows it to complete by the end. Ready
+ * operations are ordered by their latency-weighted distance from the leaves of
+ * the graph, and units are assigned under the same machine rules as the
+ * forward scheduler. The rows are then reversed into a forward schedule.
+ */
+Schedule Scheduler::backwardSchedule(const DependenceGraph& graph) {
+
+    int n = graph.numNodes();
+    int width = machine.width;
+    unsigned allUnits = (1u << width) - 1;
+    unsigned unitsFor[Machine::NUM_OPCODES];
+    for (int i = 0; i < Machine::NUM_OPCODES; i++) {
+        unitsFor[i] = machine.unitsFor((Opcode) i);
+    }
 
-            // Adjust dependencies of dependent operations
-            for (const auto& edge : graph.nodes[f1]->inEdges) {
-                if (edge.weight == 1){
-                    dependencies[edge.to]--;
-                }
+    // Forward distance of every node from the leaves (program order is a
+    // topological order, since every edge points to an earlier operation)
+    std::vector<int> distance(n + 1, 0);
+    for (int id = 1; id <= n; id++) {
+        for (const auto& edge : graph.outEdges(id)) {
+            distance[id] = std::max(distance[id], distance[edge.to] + edge.weight);
+        }
+    }
+
+    // Dependents left to place, and the earliest reverse cycle of each node
+    std::vector<int> dependents(n + 1);
+    std::vector<int> earliest(n + 1);
+    RetirementWheel waiting (machine.maxLatency());
+    OperationPriorityQueue ready;
+    for (int id = 1; id <= n; id++) {
+        dependents[id] = graph.inEdges(id).size();
+        earliest[id] = machine.latency[(int) graph[id].op.opcode] - 1;
+        if (dependents[id] == 0) {
+            if (earliest[id] == 0) {
+                ready.push({id, distance[id]});
+            } else {
+                waiting.insert(earliest[id], id);
             }
+        }
+    }
 
-            // Assign operation in f1 to op1
-            op1 = graph.nodes[f1]->data.op;
-        } else {
+    // Fill reverse cycles 0, 1, ... with node ids (0 for an idle unit)
+    std::vector<int> rows;
+    std::vector<int> defer;
+    int cycle = 0;
+    while (!ready.empty() || !waiting.empty()) {
+
+        if (ready.empty()) {
+            int next = waiting.nextEvent(cycle);
+            rows.insert(rows.end(), (size_t) (next - cycle) * width, 0);
+            cycle = next;
+            for (int id : waiting.take(cycle)) {
+                ready.push({id, distance[id]});
+            }
+            continue;
+        }
 
-            // Otherwise, schedule a NOP
-            op1 = {Opcode::NOP, {}, {}, {}};
+        CycleAssignment<Machine::MAX_WIDTH> units;
+        defer.clear();
+        while (units.busy != allUnits && !ready.empty()) {
+            OperationPriority op = ready.top();
+            ready.pop();
+            if (!units.place(op.id, (int) graph[op.id].op.opcode, unitsFor, machine.limit)) {
+                defer.push_back(op.id);
+            }
+        }
+        for (int id : defer) {
+            ready.push({id, distance[id]});
         }
 
-        // Add scheduled operations to output list
-        schedule.cycles.push_back({op0, op1});
+        // Place the operations and release what they depend on
+        for (int u = 0; u < width; u++) {
+            int id = units.busy & (1u << u) ? units.unit[u] : 0;
+            rows.push_back(id);
+            if (id == 0) {
+                continue;
+            }
+            for (const auto& edge : graph.outEdges(id)) {
+                earliest[edge.to] = std::max(earliest[edge.to], cycle + edge.weight);
+                if (--dependents[edge.to] == 0) {
+                    waiting.insert(earliest[edge.to], edge.to);
+                }
+            }
+        }
 
-        // Next cycle        
         cycle++;
+        for (int id : waiting.take(cycle)) {
+            ready.push({id, distance[id]});
+        }
+    }
 
-        // For each active operation
-        for (auto it = active.begin(); it != active.end(); ) {
-            int id = *it;
-            
-            // If the operation has completed:
-            if (scheduledCycle[id] + Latency[(int) graph.nodes[id]->data.op.opcode] <= cycle) {
-
-                // Remove it from the active set
-                it = active.erase(it);
-                graph.nodes[id]->data.status = Status::RETIRED;
+    // Reverse into forward order, dropping idle cycles after the last
+    // operation completes
+    int cycles = rows.size() / width;
+    int length = 0;
+    Schedule schedule;
+    schedule.width = width;
+    schedule.slots.reserve(rows.size());
+    for (int c = cycles - 1; c >= 0; c--) {
+        for (int u = 0; u < width; u++) {
+            int id = rows[(size_t) c * width + u];
+            schedule.slots.push_back(id != 0 ? graph[id].op : NOP_OPERATION);
+            if (id != 0) {
+                length = std::max(length, cycles - c + machine.latency[(int) graph[id].op.opcode] - 1);
+            }
+        }
+    }
+    schedule.slots.resize((size_t) length * width);
 
-                // For dependent operations
-                for (const auto& edge : graph.nodes[id]->inEdges) {
+    return schedule;
+}
 
-                    // Decrease dependency count (if not already)
-                    if (edge.weight > 1){
-                        dependencies[edge.to]--;
-                    }
-                }  
-            } 
+DependenceGraph Scheduler::buildDependenceGraph(const InternalRepresentation& rep) {
 
-            // The operation is an active multi-cycle operation
-            else {
-                ++it;
-            }
+    // VRs are dense, 0..maxVR - 1 after renaming
+    return buildGraph<&Operand::VR>(rep, std::max(rep.maxVR, 0) + 1);
+}
 
-            // For dependent operations
-            for (const auto& edge : graph.nodes[id]->inEdges) {
+static constexpr int64_t UNKNOWN_ADDRESS = -1;
+
+// Address of each operation that accesses memory, when it is a known
+// constant: loadI values folded through arithmetic by Optimizer::fold.
+// Values are tracked forward in program order, so the table can be keyed by
+// SR as well as by VR. Addresses that are negative or not word aligned are
+// unknown.
+template<int Operand::*Register>
+static std::vector<int64_t> constantAddresses(const InternalRepresentation& rep, int registers) {
+
+    std::vector<int64_t> value(registers, Optimizer::UNKNOWN);
+    std::vector<int64_t> addresses(rep.operations.size(), UNKNOWN_ADDRESS);
+    auto address = [] (int64_t v) {
+        return v >= 0 && v <= INT32_MAX && v % 4 == 0 ? v : UNKNOWN_ADDRESS;
+    };
+
+    for (size_t i = 0; i < rep.operations.size(); i++) {
+        const Operation& op = rep.operations[i];
+        int64_t result = Optimizer::UNKNOWN;
+        switch (op.opcode) {
+            case Opcode::LOAD:
+                addresses[i] = address(value[op.op1.*Register]);
+                break;
+            case Opcode::STORE:
+                addresses[i] = address(value[op.op3.*Register]);
+                break;
+            case Opcode::OUTPUT:
+                addresses[i] = address(op.op1.SR);
+                break;
+            case Opcode::LOADI:
+                result = op.op1.SR;
+                break;
+            case Opcode::ADD:
+            case Opcode::SUB:
+            case Opcode::MULT:
+            case Opcode::LSHIFT:
+            case Opcode::RSHIFT:
+                result = Optimizer::fold(op.opcode, value[op.op1.*Register], value[op.op2.*Register]);
+                break;
+            default:
+                break;
+        }
 
-                // If the dependent operation has not been handled yet and 
-                // the dependency count is zero
-                if (graph.nodes[edge.to]->data.status == Status::NOT_READY && 
-                    dependencies[edge.to] == 0) {
-                    
-                    // Add to ready queue
-                    ready.push({edge.to, priorities[edge.to]});
-                    graph.nodes[edge.to]->data.status = Status::READY;
-                }
-            }
+        // Defined after the uses, which may read the same source register
+        if (op.opcode != Opcode::STORE && op.op3.*Register != -1) {
+            value[op.op3.*Register] = result;
         }
     }
 
-    return schedule;
+    return addresses;
 }
 
-DependenceGraph Scheduler::buildDependenceGraph(const InternalRepresentation& rep) {
+// Every use is connected to the latest earlier definition of its register.
+// With source registers that is the definition of its live range, so the
+// graph is the same whether it is keyed by SR or by VR.
+//
+// Loads and outputs only wait for the stores they may read: accesses to
+// distinct known addresses are independent, and an access to an unknown
+// address may alias anything. Stores stay in program order among themselves
+// (they all have the same latency, so an access that waits for the latest
+// store waits for every earlier one). Only edges that are not implied
+// transitively through that store chain are added, which keeps the number of
+// memory edges linear in the number of accesses.
+template<int Operand::*Register>
+DependenceGraph Scheduler::buildGraph(const InternalRepresentation& rep, int registers) {
     
     // Build dependence graph
     DependenceGraph graph;
-    std::unordered_map<int, int> defs;
-    int lastStore = -1;
+    graph.reserve(rep.operations.size(), 3 * rep.operations.size());
+
+    // Defining node of each register
+    std::vector<int> defs(registers, graph.getUndefined());
     int lastOutput = -1;
 
+    // The store chain, and for each known address the last store to it and
+    // the reads (loads and outputs) of it since. Known addresses are reset at
+    // each store to an unknown address, which is ordered after every earlier
+    // access. Reads since that store, and reads of unknown addresses since
+    // the last store, are the ones no store is ordered after yet.
+    struct Location {
+        int lastStore = -1;
+        std::vector<int> reads;
+    };
+    std::vector<int64_t> addresses = constantAddresses<Register>(rep, registers);
+    std::unordered_map<int64_t, Location> locations;
+    int lastStore = -1;
+    int lastUnknownStore = -1;
+    std::vector<int> reads;
+    std::vector<int> unknownReads;
+
     // For each operation
-    for (const auto& op : rep.operations) {
+    for (size_t i = 0; i < rep.operations.size(); i++) {
+        const Operation& op = rep.operations[i];
 
         // Create a node
-        int node = graph.addNode({op, Status::NOT_READY});
+        int node = graph.addNode({op});
 
-        // For each name defined by this operation
-        Operand o = op.op3;
-        if (op.opcode != Opcode::STORE && o.VR != -1) {
-            
-            // Add node to defs
-            defs[o.VR] = node;
-        }
-
-        // Function to process uses
+        // Function to process uses, returns the defining node
         auto processUse = [&] (Operand o) {
-            if (defs.find(o.VR) == defs.end()) {
-                defs[o.VR] = graph.getUndefined();
-            }
-            graph.addEdge(node, defs[o.VR], Latency[(int) graph.nodes[defs[o.VR]]->data.op.opcode]);
+            int def = defs[o.*Register];
+            graph.addEdge(node, def, machine.latency[(int) graph[def].op.opcode]);
+            return def;
         };
         
         // For each name used by this operation:
+        int use1 = -1, use2 = -1;
         switch (op.opcode) {
             case Opcode::LOAD:
                 processUse(op.op1);
                 break;
             case Opcode::STORE:
-                processUse(op.op1);
-                processUse(op.op3);
+                use1 = processUse(op.op1);
+                use2 = processUse(op.op3);
                 break;
             case Opcode::ADD:
             case Opcode::SUB:
@@ -270,75 +733,109 @@ DependenceGraph Scheduler::buildDependenceGraph(const InternalRepresentation& re
                 break;
         }
 
-        // Add conflict edges for load to last store
-        if (op.opcode == Opcode::LOAD && lastStore != -1) {
-            graph.addEdge(node, lastStore, Latency[(int) Opcode::STORE]);
+        // For each name defined by this operation (after the uses, which may
+        // read an earlier definition of the same source register)
+        Operand o = op.op3;
+        if (op.opcode != Opcode::STORE && o.*Register != -1) {
+            
+            // Add node to defs
+            defs[o.*Register] = node;
         }
 
-        // Add conflict and serialization edges for outputs
-        else if (op.opcode == Opcode::OUTPUT) {
+        if (op.opcode != Opcode::LOAD && op.opcode != Opcode::STORE && op.opcode != Opcode::OUTPUT) {
+            continue;
+        }
+
+        // Function to order this access after an earlier one, unless it is
+        // already a data dependence (the latency edge dominates)
+        auto memoryEdge = [&] (int earlier, int weight) {
+            if (earlier != -1 && earlier != use1 && earlier != use2) {
+                graph.addEdge(node, earlier, weight);
+            }
+        };
 
-            // Conflict edge to last store
-            if (lastStore != -1) { 
-                graph.addEdge(node, lastStore, Latency[(int) Opcode::STORE]);
-            } 
+        int64_t address = addresses[i];
+        Location* location = address != UNKNOWN_ADDRESS ? &locations[address] : nullptr;
+
+        // Conflict edges for loads and outputs to the last store they may
+        // read: the last store to their address, else the last store to an
+        // unknown address, or the last store of all for an unknown address
+        if (op.opcode != Opcode::STORE) {
+            int latency = machine.latency[(int) Opcode::STORE];
+            if (location != nullptr) {
+                memoryEdge(location->lastStore != -1 ? location->lastStore : lastUnknownStore, latency);
+                location->reads.push_back(node);
+            } else {
+                memoryEdge(lastStore, latency);
+                unknownReads.push_back(node);
+            }
+            reads.push_back(node);
 
             // Serialization edge to last output
-            if (lastOutput != -1) { 
-                graph.addEdge(node, lastOutput, 1);
+            if (op.opcode == Opcode::OUTPUT) {
+                memoryEdge(lastOutput, 1);
+                lastOutput = node;
             }
-            lastOutput = node; // Update last output
+            continue;
         }
 
-        // Add serialization edges for stores
-        else if (op.opcode == Opcode::STORE) {
-
-            // Edge to last store
-            if (lastStore != -1) {
-                graph.addEdge(node, lastStore, 1);
+        // Serialization edges for stores: the store chain, and the reads that
+        // may alias this store and are not ordered before an earlier store
+        memoryEdge(lastStore, 1);
+        if (location != nullptr) {
+            for (int read : location->reads) {
+                memoryEdge(read, 1);
             }
-            lastStore = node; // Update last store
-
-            // Edges to all previous loads and outputs
-            for (const auto& [id, n] : graph.nodes) {
-                if (id != graph.getUndefined()
-                && (n->data.op.opcode == Opcode::LOAD || n->data.op.opcode == Opcode::OUTPUT)) {
-                    graph.addEdge(node, id, 1);
-                }
+            for (int read : unknownReads) {
+                memoryEdge(read, 1);
             }
+            location->lastStore = node;
+            location->reads.clear();
+        } else {
+            for (int read : reads) {
+                memoryEdge(read, 1);
+            }
+            lastUnknownStore = node;
+            locations.clear();
+            reads.clear();
         }
+        unknownReads.clear();
+        lastStore = node;
     }
 
+    // Pack edges into contiguous arrays
+    graph.finalize();
+
     return graph;
 }
 
-std::unordered_map<int, int> Scheduler::getPriorities(DependenceGraph& graph) {
+std::vector<int> Scheduler::getPriorities(const DependenceGraph& graph) {
 
-    std::unordered_map<int, int> priorities;
+    std::vector<int> priorities(graph.numNodes() + 1, 0);
 
     /* Get topological order of nodes in dependence graph */ 
 
     // Initialize queue with nodes of in-degree 0 (priority 0)
-    std::unordered_map<int, int> in_degree;
+    std::vector<int> in_degree(graph.numNodes() + 1, 0);
     std::queue<int> queue = std::queue<int>();
-    for (const auto& [id, node] : graph.nodes) {
-        int degree = node->inEdges.size();
+    for (int id = 1; id <= graph.numNodes(); id++) {
+        int degree = graph.inEdges(id).size();
         in_degree[id] = degree;
-        if (degree == 0 && id != graph.getUndefined()) {
+        if (degree == 0) {
             queue.push(id);
-            priorities[id] = 0;
         }
     }
 
     // Perform topological sort
     std::vector<int> topological_order = std::vector<int>();
+    topological_order.reserve(graph.numNodes());
     while (!queue.empty()) {
         int node_id = queue.front();
         queue.pop();
         topological_order.push_back(node_id);
-        for (const auto& edge : graph.nodes[node_id]->outEdges) {
+        for (const auto& edge : graph.outEdges(node_id)) {
             in_degree[edge.to]--;
-            if (in_degree[edge.to] == 0) {
+            if (in_degree[edge.to] == 0 && edge.to != graph.getUndefined()) {
                 queue.push(edge.to);
             }
         }
@@ -346,10 +843,120 @@ std::unordered_map<int, int> Scheduler::getPriorities(DependenceGraph& graph) {
 
     /* Compute priorities as maximum latency-weighted distance */
     for (int id: topological_order) {
-        for (const auto& edge : graph.nodes[id]->outEdges) {
+        for (const auto& edge : graph.outEdges(id)) {
             priorities[edge.to] = std::max(priorities[edge.to], priorities[id] + edge.weight);
         }
     }
 
     return priorities;
-}
\ No newline at end of file
+}
+
+const char* heuristicName(Heuristic heuristic) {
+    static const char* names[(int) Heuristic::NUM_HEURISTICS] = {
+        "critical-path", "successors", "descendant-latency", "unit-pressure", "random-1", "random-2", "random-3"
+    };
+    return names[(int) heuristic];
+}
+
+/*
+ * Priorities for one portfolio heuristic. Operations are ordered by their
+ * longest path and then by the heuristic's tie-breaking key, and the
+ * priority is the rank in that order, so equal pairs keep breaking ties in
+ * program order.
+ */
+std::vector<int> Scheduler::getPriorities(const DependenceGraph& graph, Heuristic heuristic) {
+
+    std::vector<int> path = getPriorities(graph);
+    if (heuristic == Heuristic::CRITICAL_PATH) {
+        return path;
+    }
+
+    int n = graph.numNodes();
+    std::vector<int64_t> key(n + 1, 0);
+    switch (heuristic) {
+        case Heuristic::SUCCESSORS:
+            for (int id = 1; id <= n; id++) {
+                key[id] = graph.inEdges(id).size();
+            }
+            break;
+
+        // Dependents always come later in program order. Sums are counted
+        // along every path, so they saturate rather than overflow.
+        case Heuristic::DESCENDANT_LATENCY:
+            for (int id = n; id >= 1; id--) {
+                for (const auto& edge : graph.inEdges(id)) {
+                    int64_t sum = key[id] + key[edge.to] + machine.latency[(int) graph[edge.to].op.opcode];
+                    key[id] = std::min<int64_t>(sum, INT64_C(1) << 48);
+                }
+            }
+            break;
+
+        // Operations that few units can execute first, then long latencies
+        case Heuristic::UNIT_PRESSURE:
+            for (int id = 1; id <= n; id++) {
+                int opcode = (int) graph[id].op.opcode;
+                key[id] = (Machine::MAX_WIDTH - __builtin_popcount(machine.unitsFor((Opcode) opcode))) * 256 + machine.latency[opcode];
+            }
+            break;
+
+        // splitmix64 of the id, with a fixed seed per heuristic
+        default: {
+            uint64_t seed = (uint64_t) heuristic - (uint64_t) Heuristic::RANDOM_1 + 1;
+            for (int id = 1; id <= n; id++) {
+                uint64_t z = seed * 0x9e3779b97f4a7c15ULL + (uint64_t) id * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                key[id] = (z ^ (z >> 31)) >> 1;
+            }
+            break;
+        }
+    }
+
+    // Rank by (path, key)
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) {
+        order[i] = i + 1;
+    }
+    std::sort(order.begin(), order.end(), [&] (int a, int b) {
+        return path[a] != path[b] ? path[a] < path[b] : key[a] < key[b];
+    });
+    std::vector<int> priorities(n + 1, 0);
+    int rank = 0;
+    for (int i = 0; i < n; i++) {
+        int id = order[i];
+        if (i == 0 || path[id] != path[order[i - 1]] || key[id] != key[order[i - 1]]) {
+            rank++;
+        }
+        priorities[id] = rank;
+    }
+
+    return priorities;
+}
+
+/*
+ * Fused front end. The graph is built in one forward pass keyed by source
+ * register, so it does not wait for renaming. Every edge points from a later
+ * operation to an earlier one, so reverse program order is a topological
+ * order: one backward sweep then renames each operation and, since all of its
+ * dependents have been visited, pushes its final priority along its edges.
+ */
+DependenceGraph Scheduler::buildFused(InternalRepresentation& rep, std::vector<int>& priorities) {
+
+    // Uses of undefined registers are connected to the sentinel node and
+    // reported by the renaming check below
+    DependenceGraph graph = buildGraph<&Operand::SR>(rep, rep.maxSR + 1);
+
+    RenameState state (rep.maxSR + 1);
+    priorities.assign(graph.numNodes() + 1, 0);
+    for (int id = graph.numNodes(); id >= 1; id--) {
+        Operation& op = graph[id].op;
+        Renamer::renameOperation(op, id, state);
+        rep.operations[id - 1] = op;
+        for (const auto& edge : graph.outEdges(id)) {
+            priorities[edge.to] = std::max(priorities[edge.to], priorities[id] + edge.weight);
+        }
+    }
+    Renamer::finish(rep, state);
+
+    return graph;
+}
@@ -0,0 +1,98 @@
+#include <ScheduleReport.hpp>
+#include <ScheduleBound.hpp>
+#include <cstdio>
+
+ScheduleReport ScheduleReport::analyze(const DependenceGraph& graph, const Schedule& schedule, const Machine& machine) {
+
+    ScheduleReport report;
+    int n = graph.numNodes();
+    report.operations = n;
+    report.cycles = schedule.numCycles();
+
+    // The bound branch and bound starts from, for the empty schedule
+    ScheduleBound bound(graph, machine);
+    report.lowerBound = bound.compute(SearchState::initial(graph));
+    report.criticalPath = bound.pathBound();
+    for (size_t r = 0; r < bound.resources().size(); r++) {
+        report.resources.push_back({bound.resources()[r], bound.resourceOperations(r), bound.resourceBound(r)});
+    }
+
+    // Busy issue slots of each unit
+    report.utilization.assign(schedule.width, 0);
+    for (size_t c = 0; c < schedule.numCycles(); c++) {
+        for (int u = 0; u < schedule.width; u++) {
+            bool idle = schedule.cycle(c)[u].opcode == Opcode::NOP;
+            report.nopSlots += idle;
+            report.utilization[u] += !idle;
+        }
+    }
+    for (double& busy : report.utilization) {
+        busy = report.cycles > 0 ? busy / report.cycles : 0;
+    }
+
+    return report;
+}
+
+void ScheduleReport::print(std::ostream& out, const std::string& name) const {
+
+    out << "{\"block\":\"";
+    for (char c : name) {
+        switch (c) {
+            case '"':
+            case '\\':
+                out << '\\' << c;
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            default:
+                // Other control characters as \u00XX
+                if ((unsigned char) c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char) c);
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+                break;
+        }
+    }
+    out << "\",\"operations\":" << operations << ",\"cycles\":" << cycles;
+
+    out << ",\"bounds\":{\"criticalPath\":" << criticalPath << ",\"resources\":[";
+    for (size_t r = 0; r < resources.size(); r++) {
+        const ResourceBound& entry = resources[r];
+        out << (r > 0 ? "," : "") << "{\"opcodes\":[";
+        const char* separator = "";
+        for (int i = 0; i < Machine::NUM_OPCODES; i++) {
+            if (entry.resource.opcodes & Machine::mask((Opcode) i)) {
+                out << separator << "\"" << OpcodeNames[i] << "\"";
+                separator = ",";
+            }
+        }
+        out << "],\"units\":[";
+        separator = "";
+        for (int u = 0; u < Machine::MAX_WIDTH; u++) {
+            if (entry.resource.units & (1u << u)) {
+                out << separator << u;
+                separator = ",";
+            }
+        }
+        out << "],\"capacity\":" << entry.resource.capacity << ",\"operations\":" << entry.operations
+            << ",\"bound\":" << entry.bound << "}";
+    }
+    out << "],\"best\":" << lowerBound << "}";
+
+    out << ",\"gap\":" << gap() << ",\"gapPercent\":" << (lowerBound > 0 ? 100.0 * gap() / lowerBound : 0)
+        << ",\"nopSlots\":" << nopSlots << ",\"utilization\":[";
+    for (size_t u = 0; u < utilization.size(); u++) {
+        out << (u > 0 ? "," : "") << utilization[u];
+    }
+    out << "]}\n";
+}
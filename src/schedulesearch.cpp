@@ -0,0 +1,158 @@
+#include <ScheduleSearch.hpp>
+#include <algorithm>
+#include <climits>
+
+SearchState SearchState::initial(const DependenceGraph& graph) {
+
+    int n = graph.numNodes();
+    SearchState initial;
+    initial.pending.resize(n + 1);
+    initial.earliest.assign(n + 1, 1);
+    for (int id = 1; id <= n; id++) {
+        initial.pending[id] = graph.outEdges(id).size();
+        if (initial.pending[id] == 0) {
+            initial.ready.push_back(id);
+        }
+    }
+    return initial;
+}
+
+ScheduleSearch::ScheduleSearch(const DependenceGraph& graph, const std::vector<int>& priorities, const Machine& machine)
+    : graph(graph), priorities(priorities), machine(machine) {
+    for (int i = 0; i < Machine::NUM_OPCODES; i++) {
+        unitsFor[i] = machine.unitsFor((Opcode) i);
+    }
+}
+
+void ScheduleSearch::skipIdle(SearchState& state, std::vector<int>& rows) const {
+
+    int next = INT_MAX;
+    for (int id : state.ready) {
+        next = std::min(next, state.earliest[id]);
+    }
+    if (next > state.cycle) {
+        rows.resize(rows.size() + (size_t) (next - state.cycle) * machine.width, 0);
+        state.cycle = next;
+    }
+}
+
+std::vector<int> ScheduleSearch::candidates(const SearchState& state) const {
+
+    std::vector<int> result;
+    for (int id : state.ready) {
+        if (state.earliest[id] <= state.cycle) {
+            result.push_back(id);
+        }
+    }
+    std::sort(result.begin(), result.end(), [&] (int a, int b) {
+        if (priorities[a] != priorities[b]) {
+            return priorities[a] > priorities[b];
+        }
+        return a < b;
+    });
+    return result;
+}
+
+bool ScheduleSearch::assignments(const std::vector<int>& candidates, int branching, size_t maxLeaves,
+                                 std::vector<Assignment>& result) const {
+
+    unsigned allUnits = (1u << machine.width) - 1;
+    std::vector<std::pair<long, Assignment>> leaves;
+    bool truncated = false;
+
+    // Include-first depth-first search, so the first leaf is the greedy choice
+    auto search = [&] (auto& self, int i, const Assignment& units, long score) -> void {
+        if (leaves.size() >= maxLeaves) {
+            truncated = true;
+            return;
+        }
+        if (i == (int) candidates.size() || units.busy == allUnits) {
+
+            // Only keep maximal assignments
+            for (int j = 0; j < i; j++) {
+                Assignment probe = units;
+                if (!assigned(units, candidates[j])
+                    && probe.place(candidates[j], (int) graph[candidates[j]].op.opcode, unitsFor, machine.limit)) {
+                    return;
+                }
+            }
+            leaves.push_back({score, units});
+            return;
+        }
+
+        int id = candidates[i];
+        Assignment with = units;
+        bool placed = with.place(id, (int) graph[id].op.opcode, unitsFor, machine.limit);
+        if (placed) {
+            self(self, i + 1, with, score + priorities[id]);
+        }
+        if (!placed || i < branching) {
+            self(self, i + 1, units, score);
+        }
+    };
+    search(search, 0, Assignment(), 0);
+
+    if (leaves.empty()) {
+        return !truncated;
+    }
+    std::stable_sort(leaves.begin() + 1, leaves.end(), [] (const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+    for (const auto& leaf : leaves) {
+        result.push_back(leaf.second);
+    }
+    return !truncated;
+}
+
+void ScheduleSearch::issueCycle(SearchState& state, const Assignment& units, const std::vector<int>& tail,
+                                std::vector<int>& rows) const {
+
+    for (int u = 0; u < machine.width; u++) {
+        int id = units.busy & (1u << u) ? units.unit[u] : 0;
+        rows.push_back(id);
+        if (id == 0) {
+            continue;
+        }
+
+        int latency = machine.latency[(int) graph[id].op.opcode];
+        state.pending[id] = -1;
+        state.scheduled++;
+        state.finish = std::max(state.finish, state.cycle + latency - 1);
+        state.pathBound = std::max(state.pathBound, state.cycle + tail[id]);
+
+        // Release dependents, which may issue once every edge weight has elapsed
+        for (const auto& edge : graph.inEdges(id)) {
+            state.earliest[edge.to] = std::max(state.earliest[edge.to], state.cycle + edge.weight);
+            if (--state.pending[edge.to] == 0) {
+                state.ready.push_back(edge.to);
+            }
+        }
+    }
+
+    // Drop issued operations from the ready list
+    state.ready.erase(std::remove_if(state.ready.begin(), state.ready.end(), [&] (int id) {
+        return state.pending[id] == -1;
+    }), state.ready.end());
+    state.cycle++;
+}
+
+void ScheduleSearch::materialise(const std::vector<int>& rows, int length, Schedule& result) const {
+
+    int width = machine.width;
+    result.width = width;
+    result.slots.clear();
+    result.slots.reserve((size_t) length * width);
+    for (int id : rows) {
+        result.slots.push_back(id != 0 ? graph[id].op : NOP_OPERATION);
+    }
+    result.slots.resize((size_t) length * width, NOP_OPERATION);
+}
+
+bool ScheduleSearch::assigned(const Assignment& units, int id) const {
+    for (int u = 0; u < machine.width; u++) {
+        if ((units.busy & (1u << u)) && units.unit[u] == id) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,68 @@
+#include <Stats.hpp>
+#include <iomanip>
+#include <sstream>
+
+static const char* PhaseNames[Stats::NUM_PHASES] = {"scan+parse", "optimize", "rename", "graph", "priorities", "fused", "schedule", "search", "output"};
+
+void Stats::print(std::ostream& out, bool json) const {
+
+    const std::pair<const char*, long> counters[] = {
+        {"tokens", tokens},
+        {"operations", operations},
+        {"folded", folded},
+        {"removed", removed},
+        {"maxSR", maxSR},
+        {"maxVR", maxVR},
+        {"maxLive", maxLive},
+        {"nodes", nodes},
+        {"edges", edges},
+        {"readyPushes", readyPushes},
+        {"deferrals", deferrals},
+        {"greedyCycles", greedyCycles},
+        {"backwardCycles", backwardCycles},
+        {"cycles", cycles},
+        {"nopSlots", nopSlots},
+        {"peakLive", peakLive},
+        {"searchStates", searchStates},
+        {"optimal", optimal}
+    };
+
+    double total = 0;
+    for (int p = 0; p < NUM_PHASES; p++) {
+        total += seconds[p];
+    }
+
+    if (json) {
+        out << "{\"seconds\":{";
+        for (int p = 0; p < NUM_PHASES; p++) {
+            out << "\"" << PhaseNames[p] << "\":" << seconds[p] << ",";
+        }
+        out << "\"total\":" << total << "},\"counters\":{";
+        for (size_t i = 0; i < std::size(counters); i++) {
+            out << (i > 0 ? "," : "") << "\"" << counters[i].first << "\":" << counters[i].second;
+        }
+        out << "}";
+        if (heuristic != nullptr) {
+            out << ",\"heuristic\":\"" << heuristic << "\"";
+        }
+        out << "}\n";
+        return;
+    }
+
+    // Formatted on the side, so the caller's stream keeps its flags
+    std::ostringstream text;
+    text << "Phase times:\n";
+    for (int p = 0; p < NUM_PHASES; p++) {
+        text << "   " << std::left << std::setw(12) << PhaseNames[p] << std::right << std::fixed << std::setprecision(3) << std::setw(10) << seconds[p] * 1e3 << " ms\n";
+    }
+    text << "   " << std::left << std::setw(12) << "total" << std::right << std::setw(10) << total * 1e3 << " ms\n";
+    text << "Counters:\n";
+    for (const auto& [name, value] : counters) {
+        text << "   " << std::left << std::setw(12) << name << std::right << std::setw(10) << value << "\n";
+    }
+    if (heuristic != nullptr) {
+        text << "Heuristic: " << heuristic << "\n";
+    }
+    out << text.str();
+    out.flush();
+}
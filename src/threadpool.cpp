@@ -0,0 +1,91 @@
+#include <ThreadPool.hpp>
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads) : pending(0), nextQueue(0), stopping(false) {
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::defaultThreads() {
+    return std::max<int>(std::thread::hardware_concurrency(), 1);
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    int target;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        target = nextQueue;
+        nextQueue = (nextQueue + 1) % queues.size();
+        pending++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+}
+
+bool ThreadPool::tryTake(int self, std::function<void()>& task) {
+
+    // Take the oldest task from this worker's own queue
+    {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Otherwise steal the newest task from another worker
+    for (size_t i = 1; i < queues.size(); i++) {
+        Queue& other = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.back());
+            other.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::run(int self) {
+    std::function<void()> task;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [&] { return pending > 0 || stopping; });
+            if (pending == 0) {
+                return;
+            }
+            pending--;
+        }
+
+        // A task is reserved for this worker, so one of the queues holds it
+        while (!tryTake(self, task)) {
+            std::this_thread::yield();
+        }
+        task();
+        task = nullptr;
+    }
+}
@@ -0,0 +1,9 @@
+loadI 1024 => r1
+mult r1, r1 => r3
+add r1, r1 => r4
+load r1 => r5
+mult r3, r3 => r6
+add r4, r4 => r7
+add r7, r7 => r8
+add r8, r8 => r9
+add r9, r9 => r10
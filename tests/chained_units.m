@@ -0,0 +1,6 @@
+# Three units whose opcode sets overlap in a chain: a load can only go on
+# unit 0 once the mult there moves to unit 1 and the add on unit 1 to unit 2
+width 3
+unit 0 load mult
+unit 1 mult add
+unit 2 add loadI output store sub lshift rshift
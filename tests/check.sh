@@ -0,0 +1,110 @@
+#!/bin/bash
+#
+# Regression checks, run by `make check` from the repository root. Each check
+# prints one line; the script fails if any check fails.
+
+SCHEDULE=./schedule
+GENERATE=./build/bench/generate
+BLOCKS=build/bench
+failures=0
+
+pass () {
+   echo "PASS $1"
+}
+
+fail () {
+   echo "FAIL $1"
+   failures=$((failures + 1))
+}
+
+# -c must reject the same inputs as the renamer, even when the operation
+# reading an undefined register is dead
+expected=$($SCHEDULE tests/undefined_use.i 2>&1)
+actual=$($SCHEDULE -c tests/undefined_use.i 2>&1)
+if [ "$actual" == "$expected" ] && [[ "$actual" == *"no prior definition"* ]]; then
+   pass "cleanup reports undefined uses"
+else
+   fail "cleanup reports undefined uses"
+fi
+
+# Scanning must not allocate per token (numeric lexemes are decoded in place)
+if ./build/bench/allocations 100000; then
+   pass "scanner makes no allocations"
+else
+   fail "scanner makes no allocations"
+fi
+
+# --report must escape control characters in the block name
+name=$(printf "$BLOCKS/check\tname\001.i")
+printf "loadI 4 => r1\noutput 4\n" > "$name"
+if $SCHEDULE --report "$name" 2>&1 >/dev/null | grep -qF '"block":"build/bench/check\tname\u0001.i"'; then
+   pass "report escapes the block name"
+else
+   fail "report escapes the block name"
+fi
+rm -f "$name"
+
+# A machine description need not list nop, which every unit can execute
+printf "width 3\nunit 0 load mult loadI\nunit 1 load add output\nunit 2 mult store sub lshift rshift\n" > $BLOCKS/check_nop.m
+printf "loadI 1 => r1\noutput 1\n" > $BLOCKS/check_nop.i
+if [ "$($SCHEDULE -m $BLOCKS/check_nop.m $BLOCKS/check_nop.i 2>&1)" == "[ loadI  1 => r0 ; output 1 ; nop     ]" ]; then
+   pass "machine descriptions need not list nop"
+else
+   fail "machine descriptions need not list nop"
+fi
+rm -f $BLOCKS/check_nop.m $BLOCKS/check_nop.i
+
+# On units with chained opcode sets, placing an operation may move two
+# others: the load, mult and add of cycle 2 all issue together
+cycles=$($SCHEDULE -m tests/chained_units.m tests/chained_units.i 2>&1 | wc -l)
+if [ "$cycles" -eq 7 ]; then
+   pass "placement moves operations along chained units"
+else
+   fail "placement moves operations along chained units ($cycles cycles, expected 7)"
+fi
+
+# Branch and bound may only claim optimality when it was exhaustive: on
+# three units the shortest schedule needs placements beyond a single move
+report=$($SCHEDULE -t -o 2000 -m tests/three_units.m tests/three_units.i 2>&1)
+cycles=$(echo "$report" | grep -c "^\[")
+if [ "$cycles" -eq 17 ] && [[ "$report" == *"optimal              1"* ]]; then
+   pass "branch and bound finds the shortest schedule on three units"
+else
+   fail "branch and bound finds the shortest schedule on three units ($cycles cycles, expected 17)"
+fi
+
+# -r and -H pick the same schedule however many of them run at once
+$GENERATE -n 20000 -s 4 > $BLOCKS/check_threads.i
+if cmp -s <($SCHEDULE -r -H -j 1 $BLOCKS/check_threads.i 2>&1) <($SCHEDULE -r -H -j 8 $BLOCKS/check_threads.i 2>&1); then
+   pass "-r -H matches between -j 1 and -j 8"
+else
+   fail "-r -H matches between -j 1 and -j 8"
+fi
+rm -f $BLOCKS/check_threads.i
+
+# The parallel (-p) and fused (-f) front ends must print the same schedule
+# as the default pipeline. Blocks of 300,000 operations are over 1 MB and 128K operations, so
+# they are parsed in chunks and renamed in segments with four threads.
+for shape in "-n 1000" "-n 300000" "-n 300000 -r 8 -s 2" "-n 300000 -w 16 -m 0.5 -s 3"; do
+   block=$BLOCKS/check_$(echo $shape | tr -d ' -').i
+   $GENERATE $shape > $block
+   $SCHEDULE $block > $block.serial 2>&1
+   $SCHEDULE -p -j 4 $block > $block.parallel 2>&1
+   if cmp -s $block.serial $block.parallel; then
+      pass "-p matches serial on generate $shape"
+   else
+      fail "-p matches serial on generate $shape"
+   fi
+   $SCHEDULE -f $block > $block.fused 2>&1
+   if cmp -s $block.serial $block.fused; then
+      pass "-f matches unfused on generate $shape"
+   else
+      fail "-f matches unfused on generate $shape"
+   fi
+   rm -f $block $block.serial $block.parallel $block.fused
+done
+
+if [ $failures -gt 0 ]; then
+   echo "$failures check(s) failed"
+   exit 1
+fi
@@ -0,0 +1,32 @@
+loadI 1024 => r0
+loadI 3 => r1
+loadI 0 => r2
+loadI 4 => r3
+loadI 8 => r4
+loadI 12 => r5
+loadI 16 => r6
+loadI 20 => r7
+sub r2, r1 => r8
+mult r3, r1 => r9
+mult r4, r1 => r10
+lshift r5, r1 => r11
+store r6 => r0
+mult r7, r1 => r12
+add r8, r1 => r13
+sub r9, r1 => r14
+add r10, r1 => r15
+load r11 => r16
+add r6, r1 => r17
+load r12 => r18
+lshift r13, r1 => r19
+lshift r14, r1 => r20
+load r15 => r21
+add r16, r1 => r22
+mult r17, r1 => r23
+sub r18, r1 => r24
+store r19 => r0
+rshift r20, r1 => r25
+add r21, r1 => r26
+add r22, r1 => r27
+mult r23, r1 => r28
+mult r24, r1 => r29
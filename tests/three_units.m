@@ -0,0 +1,6 @@
+# Loads on units 0 and 1, mults on units 0 and 2: branch and bound is only
+# exhaustive if placement finds every arrangement of a cycle's operations
+width 3
+unit 0 load mult add
+unit 1 load sub
+unit 2 mult loadI output store add lshift rshift
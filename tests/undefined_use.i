@@ -0,0 +1,3 @@
+loadI 4 => r1
+load r1 => r2
+add r2, r3 => r4